@@ -0,0 +1,751 @@
+/***********************************************************************
+ * Source File:
+ *    Benchmark : How fast are the hot paths?
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    A program of its own, separate from the game, that times the
+ *    physics, the terrain, and the drawing paths without opening a
+ *    window. Each benchmark is run enough times per sample for the
+ *    clock to be accurate, then sampled many times so the median and
+ *    a confidence interval can be reported. The results are written
+ *    as JSON. Give it the JSON of an earlier run with --baseline and
+ *    it reports, and fails on, anything that got slower.
+ *
+ *    benchmark [--filter TEXT] [--samples N] [--min-time SECONDS]
+ *              [--json FILE] [--baseline FILE] [--threshold PERCENT]
+ ************************************************************************/
+
+#include "physics.h"
+#include "ground.h"
+#include "simulator.h"
+#include "physicsCore.h"
+#include "landerBatch.h"
+#include "uiDraw.h"
+#include "drawBuffer.h"
+#include "softwareRenderer.h"
+#include "rng.h"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>   // for sort()
+#include <cmath>       // for sqrt() and fabs()
+#include <cstdio>
+#include <cstdlib>     // for atoi() and atof()
+#include <cstring>     // for strcmp() and strstr()
+#include <ctime>       // for the date of the run
+using namespace std;
+
+const int    DEFAULT_SAMPLES = 25;      // samples per benchmark
+const double DEFAULT_MIN_TIME = 0.01;   // seconds each sample must take at least
+const double DEFAULT_THRESHOLD = 5.0;   // percent slower that counts as a regression
+const int    NUM_POSITIONS = 1024;      // landers to cycle through in the ground tests
+
+/*********************************************
+ * SINK
+ * Every result is added here so the compiler
+ * cannot throw the work away
+ *********************************************/
+volatile double sink = 0.0;
+
+/*********************************************
+ * BENCHMARK
+ * Something to time: run() does the work
+ * iterations times
+ *********************************************/
+struct Benchmark
+{
+   string name;
+   void (*run)(long iterations, void * p);
+   void * p;
+};
+
+/*********************************************
+ * RESULT
+ * What one benchmark measured. Times are in
+ * nanoseconds per iteration
+ *********************************************/
+struct Result
+{
+   string name;
+   long   iterations;        // per sample
+   int    samples;
+   double min;
+   double median;
+   double mean;
+   double stddev;
+   double mad;               // median absolute deviation
+   double ci95;              // half the width of the 95% confidence interval of the mean
+   double max;
+   int    outliers;          // samples more than 3 MADs from the median
+};
+
+/*************************************************************************
+ * PHYSICS
+ * The compute* functions, fed a different value each time so the
+ * compiler cannot hoist them out of the loop
+ *************************************************************************/
+void physicsDistance(long iterations, void * p)
+{
+   physics & phys = *(physics *)p;
+   double total = 0.0;
+   for (long i = 0; i < iterations; i++)
+      total += phys.computeDistance(100.0, -10.0, (double)(i & 15), 0.1);
+   sink = sink + total;
+}
+
+void physicsAcceleration(long iterations, void * p)
+{
+   physics & phys = *(physics *)p;
+   double total = 0.0;
+   for (long i = 0; i < iterations; i++)
+      total += phys.computeAcceleration(45000.0 + (double)(i & 15), 15103.0);
+   sink = sink + total;
+}
+
+void physicsVelocity(long iterations, void * p)
+{
+   physics & phys = *(physics *)p;
+   double total = 0.0;
+   for (long i = 0; i < iterations; i++)
+      total += phys.computeVelocity(-10.0, (double)(i & 15), 0.1);
+   sink = sink + total;
+}
+
+void physicsComponents(long iterations, void * p)
+{
+   physics & phys = *(physics *)p;
+   double total = 0.0;
+   for (long i = 0; i < iterations; i++)
+   {
+      double angle = phys.radiansFromDegrees((double)(i % 360));
+      total += phys.computeVerticalComponent(angle, 2.98);
+      total += phys.computeHorizontalComponent(angle, 2.98);
+   }
+   sink = sink + total;
+}
+
+void physicsTotal(long iterations, void * p)
+{
+   physics & phys = *(physics *)p;
+   double total = 0.0;
+   for (long i = 0; i < iterations; i++)
+      total += phys.computeTotalComponent((double)(i & 15), -10.0);
+   sink = sink + total;
+}
+
+/*************************************************************************
+ * GROUND RESET
+ * Make a whole new ground, the same one every time
+ *************************************************************************/
+void groundReset(long iterations, void * p)
+{
+   Ground & ground = *(Ground *)p;
+   for (long i = 0; i < iterations; i++)
+   {
+      Random rng(1, (uint64_t)i);
+      ground.reset(rng);
+   }
+   sink = sink + ground.maxElevation(0, 0);
+}
+
+/*********************************************
+ * GROUND TEST
+ * A ground, landers scattered over it, and
+ * how wide the landers are
+ *********************************************/
+struct GroundTest
+{
+   GroundTest(const Ground & ground, int landerWidth) :
+      ground(ground), landerWidth(landerWidth)
+   {
+      Random rng(2);
+      const Point & ptUpperRight = ground.getUpperRight();
+      for (int i = 0; i < NUM_POSITIONS; i++)
+         positions.push_back(Point(rng.nextDouble(0.0, ptUpperRight.getX()),
+                                   rng.nextDouble(0.0, ptUpperRight.getY() / 2.0)));
+   }
+
+   const Ground & ground;
+   int landerWidth;
+   vector<Point> positions;
+};
+
+void groundHit(long iterations, void * p)
+{
+   const GroundTest & test = *(const GroundTest *)p;
+   int hits = 0;
+   for (long i = 0; i < iterations; i++)
+      hits += test.ground.hitGround(test.positions[i & (NUM_POSITIONS - 1)],
+                                    test.landerWidth);
+   sink = sink + hits;
+}
+
+void groundOnPlatform(long iterations, void * p)
+{
+   const GroundTest & test = *(const GroundTest *)p;
+   int hits = 0;
+   for (long i = 0; i < iterations; i++)
+      hits += test.ground.onPlatform(test.positions[i & (NUM_POSITIONS - 1)],
+                                     test.landerWidth);
+   sink = sink + hits;
+}
+
+void groundSweptHit(long iterations, void * p)
+{
+   const GroundTest & test = *(const GroundTest *)p;
+   int hits = 0;
+   double t = 0.0;
+   int column = 0;
+   for (long i = 0; i < iterations; i++)
+   {
+      // a fast step: 15 columns across and 10 down
+      const Point & from = test.positions[i & (NUM_POSITIONS - 1)];
+      Point to(from.getX() + ((i & 1) ? 15.0 : -15.0), from.getY() - 10.0);
+      hits += test.ground.sweptHit(from, to, test.landerWidth, t, column);
+   }
+   sink = sink + hits + t;
+}
+
+/*************************************************************************
+ * COAST
+ * A lander thrown up with the engine off, all the way down to the
+ * ground: one step at a time, and fast forwarded
+ *************************************************************************/
+LanderState thrown(const Simulator & sim, const Ground & ground, long i)
+{
+   LanderState state = sim.start(ground.getUpperRight());
+   state.dy = 60.0;
+   state.dx = 0.3 * (double)(i % 7);
+   return state;
+}
+
+void coastStep(long iterations, void * p)
+{
+   const Ground & ground = *(const Ground *)p;
+   Simulator sim(ground);
+   LanderInput none = { false, false, false };
+   long steps = 0;
+   for (long i = 0; i < iterations; i++)
+   {
+      LanderState state = thrown(sim, ground, i);
+      while (sim.step(state, none) == FLYING)
+         steps++;
+   }
+   sink = sink + steps;
+}
+
+void coastFast(long iterations, void * p)
+{
+   const Ground & ground = *(const Ground *)p;
+   Simulator sim(ground);
+   long steps = 0;
+   for (long i = 0; i < iterations; i++)
+   {
+      LanderState state = thrown(sim, ground, i);
+      steps += sim.coast(state, 100000);
+   }
+   sink = sink + steps;
+}
+
+/*************************************************************************
+ * CORE MOVE
+ * The templated step on a batch of landers in each number type. With
+ * no ground to hit, they keep flying however many steps are timed
+ *************************************************************************/
+const int CORE_BATCH = 256;
+
+template <class T>
+void coreMove(long iterations, void * p)
+{
+   CoreState<T> start(*(const LanderState *)p);
+   std::vector<CoreState<T> > states(CORE_BATCH, start);
+   std::vector<LanderInput> inputs(CORE_BATCH);
+   for (int i = 0; i < CORE_BATCH; i++)
+   {
+      states[i].angle = T(0.01 * i);
+      inputs[i].up = (i & 1) != 0;
+      inputs[i].left = (i & 2) != 0;
+      inputs[i].right = false;
+   }
+
+   for (long done = 0; done < iterations; done += CORE_BATCH)
+   {
+      int num = (int)std::min((long)CORE_BATCH, iterations - done);
+      PhysicsCore<T>::move(&states[0], &inputs[0], num);
+   }
+   sink = sink + coreDouble(states[0].y);
+}
+
+/*************************************************************************
+ * BATCH STEP
+ * A batch of landers stepped together, with the vector kernels and
+ * without. Every so often the landers go back to the start so they are
+ * all still flying; an iteration is one lander's step
+ *************************************************************************/
+const int BATCH_SIZE = 256;
+const int BATCH_STEPS = 32;    // steps before the landers start again
+
+void batchStep(long iterations, const Ground & ground, bool vectorize)
+{
+   LanderState lander = Simulator(ground).start(ground.getUpperRight());
+   LanderBatch start(BATCH_SIZE);
+   std::vector<unsigned char> controls(BATCH_SIZE);
+   for (int i = 0; i < BATCH_SIZE; i++)
+   {
+      lander.angle = 0.01 * i;
+      start.set(i, lander);
+      controls[i] = ((i & 1) ? CONTROL_UP : 0) | ((i & 2) ? CONTROL_LEFT : 0);
+   }
+
+   LanderBatch batch = start;
+   int steps = 0;
+   for (long done = 0; done < iterations; done += BATCH_SIZE)
+   {
+      if (steps++ == BATCH_STEPS)
+      {
+         batch = start;
+         steps = 1;
+      }
+      if (vectorize)
+         batch.step(ground, &controls[0]);
+      else
+         batch.stepScalar(ground, &controls[0]);
+   }
+   sink = sink + batch.y[0];
+}
+
+void batchStepScalar(long iterations, void * p)
+{
+   batchStep(iterations, *(const Ground *)p, false /*vectorize*/);
+}
+
+void batchStepVector(long iterations, void * p)
+{
+   batchStep(iterations, *(const Ground *)p, true /*vectorize*/);
+}
+
+/*************************************************************************
+ * TEXT
+ * What the game writes in the corner every frame, formatted by
+ * ogstream and recorded into a buffer
+ *************************************************************************/
+void drawText(long iterations, void * p)
+{
+   DrawBuffer & buffer = *(DrawBuffer *)p;
+   for (long i = 0; i < iterations; i++)
+   {
+      buffer.clear();
+      ogstream gout(Point(20.0, 960.0), &buffer);
+      gout << "Fuel: " << (int)(i & 1023) << "\n";
+      gout << "Altitude: " << (int)(i & 511) << "\n";
+      gout << "Speed: " << 1.0 + (double)(i & 63) * 0.1 << "\n";
+      gout.flush();
+   }
+   sink = sink + buffer.getTexts().size();
+}
+
+/*************************************************************************
+ * LANDER
+ * The draw commands for the lander and its flames, recorded
+ *************************************************************************/
+void drawLander(long iterations, void * p)
+{
+   DrawBuffer & buffer = *(DrawBuffer *)p;
+   ogstream gout(&buffer);
+   for (long i = 0; i < iterations; i++)
+   {
+      buffer.clear();
+      gout.drawLander(Point(200.0, 300.0), (double)(i & 63) * 0.1);
+   }
+   sink = sink + buffer.numVertices();
+}
+
+void drawLanderFlames(long iterations, void * p)
+{
+   DrawBuffer & buffer = *(DrawBuffer *)p;
+   ogstream gout(&buffer);
+   for (long i = 0; i < iterations; i++)
+   {
+      buffer.clear();
+      gout.drawLanderFlames(Point(200.0, 300.0), (double)(i & 63) * 0.1,
+                            true /*bottom*/, true /*left*/, true /*right*/);
+   }
+   sink = sink + buffer.numVertices();
+}
+
+/*************************************************************************
+ * SOFTWARE
+ * A whole recorded frame, the ground, a lander with its flames, stars
+ * and text, drawn into memory by the software renderer on one thread
+ *************************************************************************/
+struct SoftwareTest
+{
+   SoftwareTest(const Ground & ground) :
+      renderer((int)ground.getUpperRight().getX(), (int)ground.getUpperRight().getY())
+   {
+      const Point & ptUpperRight = ground.getUpperRight();
+      Point ptLM(ptUpperRight.getX() / 2.0, ptUpperRight.getY() * 0.8);
+      ogstream gout(Point(20.0, ptUpperRight.getY() - 40.0), &frame);
+      ground.draw(gout);
+      gout.drawLanderFlames(ptLM, 0.3, true /*bottom*/, true /*left*/, true /*right*/);
+      gout.drawLander(ptLM, 0.3);
+      for (int i = 0; i < 50; i++)
+         gout.drawStar(Point((double)(i * 37 % (int)ptUpperRight.getX()),
+                             ptUpperRight.getY() - (double)(i * 13 % 100)),
+                       (unsigned char)(i * 5));
+      gout << "Fuel: 4321\nAltitude: 287\nSpeed: 3.25\n";
+   }
+
+   DrawBuffer frame;
+   SoftwareRenderer renderer;
+};
+
+void drawSoftware(long iterations, void * p)
+{
+   SoftwareTest & test = *(SoftwareTest *)p;
+   for (long i = 0; i < iterations; i++)
+   {
+      test.renderer.clear();
+      test.renderer.render(test.frame);
+   }
+   sink = sink + test.renderer.getPixel(0, 0);
+}
+
+/*************************************************************************
+ * SECONDS
+ * Time a number of iterations
+ *************************************************************************/
+double seconds(const Benchmark & benchmark, long iterations)
+{
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   benchmark.run(iterations, benchmark.p);
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*************************************************************************
+ * T CRITICAL
+ * Student's t for a two-sided 95% interval with df degrees of freedom
+ *************************************************************************/
+double tCritical(int df)
+{
+   static const double table[] =
+   {
+      0.0,   12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+      2.228, 2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093,
+      2.086, 2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045,
+      2.042
+   };
+   if (df < 1)
+      return 0.0;
+   if (df <= 30)
+      return table[df];
+   return 1.960;
+}
+
+/*************************************************************************
+ * MEASURE
+ * Warm up while finding how many iterations make a sample take at least
+ * minTime, then take the samples and work out the statistics
+ *************************************************************************/
+Result measure(const Benchmark & benchmark, int numSamples, double minTime)
+{
+   long iterations = 1;
+   for (;;)
+   {
+      double elapsed = seconds(benchmark, iterations);
+      if (elapsed >= minTime)
+         break;
+      // aim a little past minTime, but never more than 10x at once
+      double scale = elapsed > 0.0 ? 1.2 * minTime / elapsed : 10.0;
+      iterations = (long)(iterations * (scale > 10.0 ? 10.0 : scale)) + 1;
+   }
+
+   vector<double> samples;
+   for (int i = 0; i < numSamples; i++)
+      samples.push_back(seconds(benchmark, iterations) * 1.0e9 / iterations);
+
+   Result result;
+   result.name = benchmark.name;
+   result.iterations = iterations;
+   result.samples = numSamples;
+
+   double sum = 0.0;
+   for (size_t i = 0; i < samples.size(); i++)
+      sum += samples[i];
+   result.mean = sum / numSamples;
+
+   double sumSquares = 0.0;
+   for (size_t i = 0; i < samples.size(); i++)
+      sumSquares += (samples[i] - result.mean) * (samples[i] - result.mean);
+   result.stddev = numSamples > 1 ? sqrt(sumSquares / (numSamples - 1)) : 0.0;
+   result.ci95 = tCritical(numSamples - 1) * result.stddev / sqrt((double)numSamples);
+
+   sort(samples.begin(), samples.end());
+   result.min = samples.front();
+   result.max = samples.back();
+   result.median = samples[numSamples / 2];
+   if (numSamples % 2 == 0)
+      result.median = (samples[numSamples / 2 - 1] + samples[numSamples / 2]) / 2.0;
+
+   vector<double> deviations;
+   for (size_t i = 0; i < samples.size(); i++)
+      deviations.push_back(fabs(samples[i] - result.median));
+   sort(deviations.begin(), deviations.end());
+   result.mad = deviations[numSamples / 2];
+
+   result.outliers = 0;
+   for (size_t i = 0; i < samples.size(); i++)
+      if (fabs(samples[i] - result.median) > 3.0 * 1.4826 * result.mad)
+         result.outliers++;
+
+   return result;
+}
+
+/*************************************************************************
+ * WRITE JSON
+ * One object per benchmark, in the order they ran
+ *************************************************************************/
+bool writeJson(const char * fileName, const vector<Result> & results,
+               int numSamples, double minTime)
+{
+   FILE * file = fopen(fileName, "w");
+   if (file == NULL)
+      return false;
+
+   char date[32];
+   time_t now = time(NULL);
+   strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+   fprintf(file, "{\n  \"context\": {\n");
+   fprintf(file, "    \"date\": \"%s\",\n", date);
+#if defined(__clang__)
+   fprintf(file, "    \"compiler\": \"clang %s\",\n", __clang_version__);
+#elif defined(__GNUC__)
+   fprintf(file, "    \"compiler\": \"gcc %s\",\n", __VERSION__);
+#elif defined(_MSC_VER)
+   fprintf(file, "    \"compiler\": \"msvc %d\",\n", _MSC_VER);
+#endif
+#ifdef NDEBUG
+   fprintf(file, "    \"build\": \"release\",\n");
+#else
+   fprintf(file, "    \"build\": \"debug\",\n");
+#endif
+   fprintf(file, "    \"samples\": %d,\n", numSamples);
+   fprintf(file, "    \"minTime\": %g\n", minTime);
+   fprintf(file, "  },\n  \"benchmarks\": [\n");
+
+   for (size_t i = 0; i < results.size(); i++)
+   {
+      const Result & r = results[i];
+      fprintf(file, "    {\"name\": \"%s\", \"unit\": \"ns\", \"iterations\": %ld, "
+                    "\"samples\": %d, \"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, "
+                    "\"stddev\": %.3f, \"mad\": %.3f, \"ci95\": %.3f, \"max\": %.3f, "
+                    "\"outliers\": %d}%s\n",
+              r.name.c_str(), r.iterations, r.samples, r.min, r.median, r.mean,
+              r.stddev, r.mad, r.ci95, r.max, r.outliers,
+              i + 1 < results.size() ? "," : "");
+   }
+
+   fprintf(file, "  ]\n}\n");
+   return fclose(file) == 0;
+}
+
+/*************************************************************************
+ * FIND NUMBER
+ * The number after "key": in text, starting from pos
+ *************************************************************************/
+bool findNumber(const string & text, size_t pos, const char * key, double & value)
+{
+   string quoted = string("\"") + key + "\":";
+   pos = text.find(quoted, pos);
+   if (pos == string::npos)
+      return false;
+   value = atof(text.c_str() + pos + quoted.size());
+   return true;
+}
+
+/*************************************************************************
+ * COMPARE
+ * Read a JSON file this program wrote before and report every
+ * benchmark whose median got slower by more than threshold percent
+ * and by more than the noise in both runs. Returns how many did
+ *************************************************************************/
+int compare(const char * fileName, const vector<Result> & results, double threshold)
+{
+   FILE * file = fopen(fileName, "r");
+   if (file == NULL)
+   {
+      fprintf(stderr, "Cannot read baseline %s\n", fileName);
+      return -1;
+   }
+   string text;
+   char chunk[4096];
+   size_t num;
+   while ((num = fread(chunk, 1, sizeof(chunk), file)) > 0)
+      text.append(chunk, num);
+   fclose(file);
+
+   int regressions = 0;
+   printf("\n%-28s %12s %12s %9s\n", "compared to baseline", "was ns", "now ns", "change");
+   for (size_t i = 0; i < results.size(); i++)
+   {
+      const Result & r = results[i];
+      size_t pos = text.find("\"name\": \"" + r.name + "\"");
+      double median;
+      double ci95;
+      if (pos == string::npos || !findNumber(text, pos, "median", median) ||
+          !findNumber(text, pos, "ci95", ci95))
+         continue;
+
+      double change = 100.0 * (r.median - median) / median;
+      bool slower = change > threshold && r.median - median > r.ci95 + ci95;
+      printf("%-28s %12.2f %12.2f %+8.1f%%%s\n", r.name.c_str(), median, r.median,
+             change, slower ? "  REGRESSION" : "");
+      if (slower)
+         regressions++;
+   }
+   return regressions;
+}
+
+/*********************************
+ * MAIN
+ * Set up everything there is to time,
+ * time what the filter lets through,
+ * and write the results
+ *********************************/
+int main(int argc, char ** argv)
+{
+   const char * filter = NULL;
+   const char * jsonFile = "benchmark.json";
+   const char * baseline = NULL;
+   int numSamples = DEFAULT_SAMPLES;
+   double minTime = DEFAULT_MIN_TIME;
+   double threshold = DEFAULT_THRESHOLD;
+
+   for (int i = 1; i < argc; i++)
+   {
+      if (i + 1 < argc && strcmp(argv[i], "--filter") == 0)
+         filter = argv[++i];
+      else if (i + 1 < argc && strcmp(argv[i], "--samples") == 0)
+         numSamples = atoi(argv[++i]);
+      else if (i + 1 < argc && strcmp(argv[i], "--min-time") == 0)
+         minTime = atof(argv[++i]);
+      else if (i + 1 < argc && strcmp(argv[i], "--json") == 0)
+         jsonFile = argv[++i];
+      else if (i + 1 < argc && strcmp(argv[i], "--baseline") == 0)
+         baseline = argv[++i];
+      else if (i + 1 < argc && strcmp(argv[i], "--threshold") == 0)
+         threshold = atof(argv[++i]);
+      else
+      {
+         fprintf(stderr, "usage: %s [--filter TEXT] [--samples N] [--min-time SECONDS]\n"
+                         "          [--json FILE] [--baseline FILE] [--threshold PERCENT]\n",
+                 argv[0]);
+         return 2;
+      }
+   }
+   if (numSamples < 2)
+      numSamples = 2;
+
+   // everything the benchmarks work on
+   physics phys;
+   DrawBuffer buffer;
+
+   const int widths[] = { 400, 4000, 40000 };
+   const int landerWidths[] = { 5, 20, 100 };
+   vector<Ground *> grounds;
+   for (int i = 0; i < 3; i++)
+   {
+      grounds.push_back(new Ground(Point((double)widths[i], 400.0)));
+      Random rng(1);
+      grounds.back()->reset(rng);
+   }
+   vector<GroundTest *> tests;
+   for (int i = 0; i < 3; i++)
+      tests.push_back(new GroundTest(*grounds[0], landerWidths[i]));
+   SoftwareTest software(*grounds[0]);
+
+   vector<Benchmark> benchmarks;
+   Benchmark benchmark;
+   benchmark.p = &phys;
+   benchmark.name = "physics/distance";      benchmark.run = physicsDistance;      benchmarks.push_back(benchmark);
+   benchmark.name = "physics/acceleration";  benchmark.run = physicsAcceleration;  benchmarks.push_back(benchmark);
+   benchmark.name = "physics/velocity";      benchmark.run = physicsVelocity;      benchmarks.push_back(benchmark);
+   benchmark.name = "physics/components";    benchmark.run = physicsComponents;    benchmarks.push_back(benchmark);
+   benchmark.name = "physics/total";         benchmark.run = physicsTotal;         benchmarks.push_back(benchmark);
+
+   for (int i = 0; i < 3; i++)
+   {
+      benchmark.name = "ground/reset/" + to_string(widths[i]);
+      benchmark.run = groundReset;
+      benchmark.p = grounds[i];
+      benchmarks.push_back(benchmark);
+   }
+   for (int i = 0; i < 3; i++)
+   {
+      benchmark.name = "ground/hitGround/" + to_string(landerWidths[i]);
+      benchmark.run = groundHit;
+      benchmark.p = tests[i];
+      benchmarks.push_back(benchmark);
+   }
+   benchmark.name = "ground/onPlatform";
+   benchmark.run = groundOnPlatform;
+   benchmark.p = tests[1];
+   benchmarks.push_back(benchmark);
+   benchmark.name = "ground/sweptHit";
+   benchmark.run = groundSweptHit;
+   benchmarks.push_back(benchmark);
+
+   benchmark.p = grounds[1];
+   benchmark.name = "simulator/coast/step";  benchmark.run = coastStep;  benchmarks.push_back(benchmark);
+   benchmark.name = "simulator/coast/fast";  benchmark.run = coastFast;  benchmarks.push_back(benchmark);
+
+   LanderState coreStart = Simulator(*grounds[0]).start(grounds[0]->getUpperRight());
+   benchmark.p = &coreStart;
+   benchmark.name = "core/move/double";  benchmark.run = coreMove<double>;  benchmarks.push_back(benchmark);
+   benchmark.name = "core/move/float";   benchmark.run = coreMove<float>;   benchmarks.push_back(benchmark);
+   benchmark.name = "core/move/fixed";   benchmark.run = coreMove<Fixed>;   benchmarks.push_back(benchmark);
+
+   benchmark.p = grounds[0];
+   benchmark.name = "batch/step/scalar"; benchmark.run = batchStepScalar;  benchmarks.push_back(benchmark);
+   benchmark.name = "batch/step/vector"; benchmark.run = batchStepVector;  benchmarks.push_back(benchmark);
+
+   benchmark.p = &buffer;
+   benchmark.name = "draw/text";         benchmark.run = drawText;         benchmarks.push_back(benchmark);
+   benchmark.name = "draw/lander";       benchmark.run = drawLander;       benchmarks.push_back(benchmark);
+   benchmark.name = "draw/landerFlames"; benchmark.run = drawLanderFlames; benchmarks.push_back(benchmark);
+
+   benchmark.p = &software;
+   benchmark.name = "draw/software";     benchmark.run = drawSoftware;     benchmarks.push_back(benchmark);
+
+   // run them
+   vector<Result> results;
+   printf("%-28s %12s %10s %10s %10s %5s\n",
+          "benchmark", "iterations", "median ns", "+/- 95%", "mad", "out");
+   for (size_t i = 0; i < benchmarks.size(); i++)
+   {
+      if (filter != NULL && strstr(benchmarks[i].name.c_str(), filter) == NULL)
+         continue;
+      Result r = measure(benchmarks[i], numSamples, minTime);
+      printf("%-28s %12ld %10.2f %10.2f %10.2f %5d\n", r.name.c_str(),
+             r.iterations, r.median, r.ci95, r.mad, r.outliers);
+      fflush(stdout);
+      results.push_back(r);
+   }
+
+   for (size_t i = 0; i < tests.size(); i++)
+      delete tests[i];
+   for (size_t i = 0; i < grounds.size(); i++)
+      delete grounds[i];
+
+   if (!writeJson(jsonFile, results, numSamples, minTime))
+   {
+      fprintf(stderr, "Cannot write %s\n", jsonFile);
+      return 1;
+   }
+
+   if (baseline != NULL)
+      return compare(baseline, results, threshold) == 0 ? 0 : 1;
+   return 0;
+}
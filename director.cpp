@@ -6,11 +6,136 @@
 //
 
 #include "director.hpp"
+#include <algorithm>
+#include <cassert>
 
-director::director() : frames(30) {}
+using namespace std::chrono;
 
-director::director(int f) : frames(f) {}
+const int director::MAX_CATCH_UP;
 
-void director::updateInfo() {
-    // TODO
+director::session::session(const Point & ptUpperRight, Random rng,
+                           inputSource input, void * p) :
+ground(ptUpperRight, rng), sim(ground), input(input), p(p), replay(NULL), steps(0),
+pending(0), seconds(0.0), overruns(0), done(false), ran(false) {
+    lander = sim.start(ptUpperRight);
+}
+
+director::director() : director(30) {}
+
+director::director(int f, ThreadPool * pool) : frames(f), pool(pool) {
+    assert(f > 0);
+    if (this->pool == NULL) {
+        ownPool.reset(new ThreadPool());
+        this->pool = ownPool.get();
+    }
+    report.frame = 0;
+    report.seconds = 0.0;
+    report.overBudget = false;
+    report.stepped = 0;
+    report.deferred = 0;
+}
+
+int director::add(session * s) {
+    sessions.push_back(std::unique_ptr<session>(s));
+    order.push_back((int)sessions.size() - 1);
+    return (int)sessions.size() - 1;
+}
+
+int director::addSession(const Point & ptUpperRight, uint64_t seed,
+                         inputSource input, void * p) {
+    assert(input != NULL);
+    return add(new session(ptUpperRight, Random(seed), input, p));
+}
+
+int director::addSession(Replay & replay) {
+    session * s = new session(replay.getUpperRight(), Random(replay.getSeed()), NULL, NULL);
+    s->replay = &replay;
+    replay.rewind();
+    return add(s);
+}
+
+// With every thread busy the whole frame, this is how long each session
+// can have
+double director::getShare()const {
+    if (sessions.empty())
+        return getBudget();
+    return getBudget() * pool->size() / sessions.size();
+}
+
+// Run on the pool. A session the threads get to after the deadline waits
+// for the next frame, keeping the steps it is owed
+void director::stepSessions(int begin, int end, int, void * p) {
+    director * d = (director *)p;
+    for (int i = begin; i < end; i++) {
+        session & s = *d->sessions[d->order[i]];
+        s.ran = false;
+        s.seconds = 0.0;
+        if (s.done || s.pending == 0)
+            continue;
+
+        steady_clock::time_point start = steady_clock::now();
+        if (start >= d->deadline)
+            continue;
+
+        int steps = std::min(s.pending, MAX_CATCH_UP);
+        for (int j = 0; j < steps && !s.done; j++) {
+            LanderInput input;
+            if (s.replay != NULL) {
+                unsigned int keys;
+                if (!s.replay->next(keys)) {
+                    s.done = true;
+                    break;
+                }
+                input = Replay::unpack(keys);
+            }
+            else
+                input = s.input(s.lander, s.steps, s.p);
+
+            if (s.sim.step(s.lander, input) != FLYING)
+                s.done = true;
+            s.steps++;
+            s.pending--;
+        }
+        if (s.done)
+            s.pending = 0;
+
+        s.ran = true;
+        s.seconds = duration<double>(steady_clock::now() - start).count();
+    }
+}
+
+const frameReport & director::updateInfo() {
+    steady_clock::time_point start = steady_clock::now();
+    deadline = start + duration_cast<steady_clock::duration>(duration<double>(getBudget()));
+
+    for (size_t i = 0; i < sessions.size(); i++)
+        if (!sessions[i]->done)
+            sessions[i]->pending++;
+
+    pool->parallelFor((int)order.size(), 8, stepSessions, this);
+
+    double share = getShare();
+    report.frame++;
+    report.stepped = 0;
+    report.deferred = 0;
+    report.overran.clear();
+    for (size_t i = 0; i < sessions.size(); i++) {
+        session & s = *sessions[i];
+        if (s.ran)
+            report.stepped++;
+        if (s.pending > 0)
+            report.deferred++;
+        if (s.seconds > share) {
+            s.overruns++;
+            report.overran.push_back((int)i);
+        }
+    }
+    report.seconds = duration<double>(steady_clock::now() - start).count();
+    report.overBudget = report.seconds > getBudget();
+
+    // whoever is still owed steps goes to the front of the line
+    std::stable_partition(order.begin(), order.end(), [this](int i) {
+        return sessions[i]->pending > 0;
+    });
+    return report;
 }
@@ -4,25 +4,104 @@
 //
 //  Created by Samuel on 2/1/23.
 //
+//  The director runs many games at once, each with its own ground,
+//  lander and controls. Every frame it steps all of them on a thread
+//  pool and keeps to a time budget of one frame. A session that takes
+//  more than its share of the frame is reported. Sessions that have not
+//  been reached when the frame is over wait for the next frame, and then
+//  catch up on the steps they missed.
+//
 
 #ifndef director_hpp
 #define director_hpp
 
 #include <stdio.h>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "simulator.h"
+#include "threadPool.h"
+#include "replay.h"
+
+// where a session's controls come from: a player, a replay, a bot
+typedef LanderInput (*inputSource)(const LanderState & lander, long step, void * p);
 
 /**
- DIRECTOR
- 
- From the UML class diagram for W3. Delete if not needed.
+ FRAME REPORT
+
+ How the last frame went. Times are in seconds
  */
+struct frameReport {
+    long frame;
+    double seconds;                 // the whole frame
+    bool overBudget;                // took longer than a frame
+    int stepped;                    // sessions that got to run
+    int deferred;                   // sessions that had to wait for the next frame
+    std::vector<int> overran;       // sessions that took more than their share
+};
+
 class director {
-    const int frames;
-    
+    const int frames;               // frames per second
+
 public:
     director();
-    director(int f);
-    
-    void updateInfo();
+    director(int f, ThreadPool * pool = NULL);
+
+    // a new game. Returns its number
+    int addSession(const Point & ptUpperRight, uint64_t seed,
+                   inputSource input, void * p);
+
+    // a game played back from a replay, on the replay's ground. The
+    // replay is read as the session goes, so it needs one of its own
+    int addSession(Replay & replay);
+
+    // the most steps a session that was kept waiting makes up in a frame
+    static const int MAX_CATCH_UP = 4;
+
+    // step every session once, within one frame. Sessions that have
+    // landed, crashed or run out of replay are left alone
+    const frameReport & updateInfo();
+
+    int getSessions()const { return (int)sessions.size(); }
+    const LanderState & getLander(int i)const { return sessions[i]->lander; }
+    long getSteps(int i)const { return sessions[i]->steps; }
+    long getOverruns(int i)const { return sessions[i]->overruns; }
+    const frameReport & getReport()const { return report; }
+
+    // the time a frame may take, and a session's share of it
+    double getBudget()const { return 1.0 / frames; }
+    double getShare()const;
+
+private:
+    struct session {
+        // the ground is made from rng
+        session(const Point & ptUpperRight, Random rng, inputSource input, void * p);
+
+        Ground ground;
+        Simulator sim;
+        LanderState lander;
+        inputSource input;          // NULL when the keys come from a replay
+        void * p;
+        Replay * replay;
+        long steps;                 // taken so far
+        int pending;                // owed, counting this frame
+        double seconds;             // how long this frame's steps took
+        long overruns;              // frames it took more than its share
+        bool done;                  // nothing more will happen
+        bool ran;                   // got to run this frame
+    };
+
+    int add(session * s);
+
+    static void stepSessions(int begin, int end, int thread, void * p);
+
+    std::vector<std::unique_ptr<session> > sessions;
+    std::vector<int> order;         // the sessions kept waiting go first
+    std::unique_ptr<ThreadPool> ownPool;
+    ThreadPool * pool;
+    std::chrono::steady_clock::time_point deadline;
+    frameReport report;
 };
 
 #endif /* director_hpp */
@@ -0,0 +1,257 @@
+/***********************************************************************
+ * Source File:
+ *    Draw Buffer : Drawing recorded now, put on the screen later
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Record what ogstream draws into flat arrays of vertices and colors,
+ *    broken down into points, lines, and triangles, so the whole frame
+ *    can be handed to OpenGL in a few calls.
+ ************************************************************************/
+
+#include "drawBuffer.h"  // for the DrawBuffer class definition
+#include <cassert>
+#include <algorithm>      // for std::copy()
+
+/************************************************************************
+ * CLEAR
+ * Start a new frame. The vectors keep their capacity, so after the
+ * first few frames recording does not allocate
+ ************************************************************************/
+void DrawBuffer::clear()
+{
+   assert(!inPrimitive);
+   batchList.clear();
+   vertices.clear();
+   colors.clear();
+   texts.clear();
+   numCommands = 0;
+   numPrimitives = 0;
+   current[0] = current[1] = current[2] = 1.0f;
+}
+
+/************************************************************************
+ * BEGIN
+ * Like glBegin()
+ ************************************************************************/
+void DrawBuffer::begin(DrawMode mode)
+{
+   assert(!inPrimitive);
+   this->mode = mode;
+   inPrimitive = true;
+   numPending = 0;
+   numCommands++;
+}
+
+/************************************************************************
+ * COLOR
+ * Like glColor3f(). Applies to the vertices that follow
+ ************************************************************************/
+void DrawBuffer::color(double red, double green, double blue)
+{
+   current[0] = (float)red;
+   current[1] = (float)green;
+   current[2] = (float)blue;
+}
+
+/************************************************************************
+ * PUSH
+ * Copy one of the pending vertices into the arrays
+ ************************************************************************/
+void DrawBuffer::push(int iPending)
+{
+   const float * v = pending[iPending];
+   vertices.push_back(v[0]);
+   vertices.push_back(v[1]);
+   colors.push_back(v[2]);
+   colors.push_back(v[3]);
+   colors.push_back(v[4]);
+}
+
+/************************************************************************
+ * EMIT
+ * A primitive of num vertices was just pushed. Grow the last batch if
+ * it is the same kind, otherwise start a new one
+ ************************************************************************/
+void DrawBuffer::emit(DrawMode type, int num)
+{
+   numPrimitives++;
+   if (!batchList.empty() && batchList.back().type == type)
+      batchList.back().count += num;
+   else
+   {
+      Batch batch;
+      batch.type = type;
+      batch.first = numVertices() - num;
+      batch.count = num;
+      batchList.push_back(batch);
+   }
+}
+
+/************************************************************************
+ * VERTEX
+ * Like glVertex2f(). Once enough vertices have come in to make a
+ * primitive, it is turned into points, lines, or triangles:
+ *    strips become separate lines
+ *    fans and quads become separate triangles
+ ************************************************************************/
+void DrawBuffer::vertex(double x, double y)
+{
+   assert(inPrimitive);
+   float * v = pending[numPending++];
+   v[0] = (float)x;
+   v[1] = (float)y;
+   v[2] = current[0];
+   v[3] = current[1];
+   v[4] = current[2];
+
+   switch (mode)
+   {
+      case DRAW_POINTS:
+         push(0);
+         emit(DRAW_POINTS, 1);
+         numPending = 0;
+         break;
+
+      case DRAW_LINES:
+         if (numPending == 2)
+         {
+            push(0);
+            push(1);
+            emit(DRAW_LINES, 2);
+            numPending = 0;
+         }
+         break;
+
+      case DRAW_LINE_STRIP:
+         // the end of this line is the start of the next
+         if (numPending == 2)
+         {
+            push(0);
+            push(1);
+            emit(DRAW_LINES, 2);
+            for (int i = 0; i < 5; i++)
+               pending[0][i] = pending[1][i];
+            numPending = 1;
+         }
+         break;
+
+      case DRAW_TRIANGLES:
+         if (numPending == 3)
+         {
+            push(0);
+            push(1);
+            push(2);
+            emit(DRAW_TRIANGLES, 3);
+            numPending = 0;
+         }
+         break;
+
+      case DRAW_TRIANGLE_FAN:
+         // every triangle shares the first vertex and the one before
+         if (numPending == 3)
+         {
+            push(0);
+            push(1);
+            push(2);
+            emit(DRAW_TRIANGLES, 3);
+            for (int i = 0; i < 5; i++)
+               pending[1][i] = pending[2][i];
+            numPending = 2;
+         }
+         break;
+
+      case DRAW_QUADS:
+         // two triangles sharing the first vertex
+         if (numPending == 4)
+         {
+            push(0);
+            push(1);
+            push(2);
+            emit(DRAW_TRIANGLES, 3);
+            push(0);
+            push(2);
+            push(3);
+            emit(DRAW_TRIANGLES, 3);
+            numPending = 0;
+         }
+         break;
+   }
+}
+
+/************************************************************************
+ * END
+ * Like glEnd(). Any leftover vertices are dropped, just as OpenGL
+ * drops an incomplete primitive
+ ************************************************************************/
+void DrawBuffer::end()
+{
+   assert(inPrimitive);
+   inPrimitive = false;
+   numPending = 0;
+}
+
+/************************************************************************
+ * TEXT
+ ************************************************************************/
+void DrawBuffer::text(double x, double y, const char * text)
+{
+   assert(text != NULL);
+   Text item;
+   item.x = (float)x;
+   item.y = (float)y;
+   item.text = text;
+   texts.push_back(item);
+}
+
+/************************************************************************
+ * APPEND
+ * Add another buffer's drawing after ours
+ ************************************************************************/
+void DrawBuffer::append(const DrawBuffer & rhs)
+{
+   assert(!inPrimitive);
+   int offset = numVertices();
+
+   vertices.insert(vertices.end(), rhs.vertices.begin(), rhs.vertices.end());
+   colors.insert(colors.end(), rhs.colors.begin(), rhs.colors.end());
+   texts.insert(texts.end(), rhs.texts.begin(), rhs.texts.end());
+
+   for (size_t i = 0; i < rhs.batchList.size(); i++)
+   {
+      const Batch & batch = rhs.batchList[i];
+      if (!batchList.empty() && batchList.back().type == batch.type &&
+          batchList.back().first + batchList.back().count == offset + batch.first)
+         batchList.back().count += batch.count;
+      else
+      {
+         batchList.push_back(batch);
+         batchList.back().first += offset;
+      }
+   }
+
+   numCommands += rhs.numCommands;
+   numPrimitives += rhs.numPrimitives;
+}
+
+/************************************************************************
+ * OVERWRITE
+ * Replace a run of vertices in place
+ ************************************************************************/
+void DrawBuffer::overwrite(int first, const DrawBuffer & rhs)
+{
+   assert(first >= 0);
+   assert(first + rhs.numVertices() <= numVertices());
+
+   std::copy(rhs.vertices.begin(), rhs.vertices.end(), vertices.begin() + 2 * first);
+   std::copy(rhs.colors.begin(), rhs.colors.end(), colors.begin() + 3 * first);
+}
+
+/************************************************************************
+ * BYTES
+ * How much vertex and color data will be sent
+ ************************************************************************/
+size_t DrawBuffer::bytes() const
+{
+   return (vertices.size() + colors.size()) * sizeof(float);
+}
@@ -0,0 +1,125 @@
+/***********************************************************************
+ * Header File:
+ *    Draw Buffer : Drawing recorded now, put on the screen later
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Instead of a glBegin()/glEnd() pair for every rectangle, ogstream
+ *    can record what it draws into flat arrays of vertices and colors.
+ *    Everything is broken down into points, lines, and triangles, and
+ *    primitives of the same kind that follow each other are merged into
+ *    one batch. At the end of the frame the whole buffer goes to OpenGL
+ *    with one call per batch. Nothing here touches OpenGL, so a buffer
+ *    can be filled and measured without a window or a GPU.
+ ************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef>   // for size_t
+
+/**********************************************
+ * DRAW MODE
+ * What a begin() ... end() pair is drawing.
+ * These mirror the OpenGL modes ogstream uses
+ **********************************************/
+enum DrawMode
+{
+   DRAW_POINTS,
+   DRAW_LINES,
+   DRAW_LINE_STRIP,
+   DRAW_TRIANGLES,
+   DRAW_TRIANGLE_FAN,
+   DRAW_QUADS
+};
+
+/***********************************************************
+ * DRAW BUFFER
+ * One frame's worth of drawing
+ ***********************************************************/
+class DrawBuffer
+{
+public:
+   /*********************************************
+    * BATCH
+    * A run of vertices all drawn the same way.
+    * type is DRAW_POINTS, DRAW_LINES, or
+    * DRAW_TRIANGLES
+    *********************************************/
+   struct Batch
+   {
+      DrawMode type;
+      int first;             // the first vertex
+      int count;             // how many vertices
+   };
+
+   /*********************************************
+    * TEXT
+    * A line of text, drawn after everything else
+    *********************************************/
+   struct Text
+   {
+      float x;               // the top left corner
+      float y;
+      std::string text;
+   };
+
+   DrawBuffer() : mode(DRAW_POINTS), inPrimitive(false), numPending(0),
+                  numCommands(0), numPrimitives(0)
+   {
+      current[0] = current[1] = current[2] = 1.0f;
+   }
+
+   // forget everything but keep the memory for the next frame
+   void clear();
+
+   // record drawing the same way as glBegin(), glColor3f(),
+   // glVertex2f(), and glEnd()
+   void begin(DrawMode mode);
+   void color(double red, double green, double blue);
+   void vertex(double x, double y);
+   void end();
+
+   // record a line of text
+   void text(double x, double y, const char * text);
+
+   // add everything in another buffer onto the end of this one
+   void append(const DrawBuffer & rhs);
+
+   // write the vertices of another buffer over ours, starting at
+   // vertex first. The batches stay as they are, so rhs must have been
+   // recorded the same way as the vertices it replaces
+   void overwrite(int first, const DrawBuffer & rhs);
+
+   // what to hand to OpenGL
+   const std::vector<Batch> & getBatches()   const { return batchList; }
+   const std::vector<float> & getVertices()  const { return vertices;  }  // x, y
+   const std::vector<float> & getColors()    const { return colors;    }  // r, g, b
+   const std::vector<Text> &  getTexts()     const { return texts;     }
+
+   // counters
+   int commands()   const { return numCommands;             } // begin/end pairs
+   int primitives() const { return numPrimitives;           } // points, lines, triangles
+   int batches()    const { return (int)batchList.size();   } // draw calls to submit
+   int numVertices() const { return (int)vertices.size() / 2; }
+   size_t bytes() const;                                      // of vertex and color data
+
+private:
+   // put a finished primitive in the arrays
+   void emit(DrawMode type, int num);
+   void push(int iPending);
+
+   std::vector<Batch> batchList;
+   std::vector<float> vertices;
+   std::vector<float> colors;
+   std::vector<Text>  texts;
+
+   DrawMode mode;            // what begin() was called with
+   bool inPrimitive;         // between begin() and end()?
+   float current[3];         // the current color
+   float pending[4][5];      // vertices not yet part of a primitive: x, y, r, g, b
+   int numPending;           // how many are waiting
+   int numCommands;
+   int numPrimitives;
+};
@@ -0,0 +1,70 @@
+/***********************************************************************
+ * Source File:
+ *    Fixed Timestep : Step the simulation at its own rate
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Spend wall time in whole simulation steps, with a cap on how many
+ *    steps a single frame may ask for.
+ ************************************************************************/
+
+#include "fixedTimestep.h"  // for the FixedTimestep class definition
+#include <cassert>
+
+/************************************************************************
+ * FIXED TIMESTEP constructor
+ ************************************************************************/
+FixedTimestep::FixedTimestep(double stepsPerSecond, int maxSteps) :
+   step(1.0 / stepsPerSecond), maxSteps(maxSteps), accumulator(0.0),
+   steps(0), dropped(0.0), started(false)
+{
+   assert(stepsPerSecond > 0.0);
+   assert(maxSteps > 0);
+}
+
+/************************************************************************
+ * BEGIN FRAME
+ * The first frame has nothing to measure against, so it runs one step
+ ************************************************************************/
+int FixedTimestep::beginFrame()
+{
+   Clock::time_point now = Clock::now();
+   double elapsed = step;
+   if (started)
+      elapsed = std::chrono::duration<double>(now - lastFrame).count();
+
+   lastFrame = now;
+   started = true;
+   return advance(elapsed);
+}
+
+/************************************************************************
+ * ADVANCE
+ * Add the elapsed time and take out as many whole steps as fit. If that
+ * is more than maxSteps, run maxSteps and forget the rest so we do not
+ * fall further and further behind
+ ************************************************************************/
+int FixedTimestep::advance(double elapsed)
+{
+   assert(elapsed >= 0.0);
+   accumulator += elapsed;
+
+   int num = (int)(accumulator / step);
+   if (num > maxSteps)
+   {
+      dropped += accumulator - maxSteps * step;
+      num = maxSteps;
+      accumulator = 0.0;
+   }
+   else
+      accumulator -= num * step;
+
+   // rounding can leave us a hair under zero or at a whole step
+   if (accumulator < 0.0)
+      accumulator = 0.0;
+   if (accumulator >= step)
+      accumulator = step * 0.999999;
+
+   steps += num;
+   return num;
+}
@@ -0,0 +1,68 @@
+/***********************************************************************
+ * Header File:
+ *    Fixed Timestep : Step the simulation at its own rate
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Wall time is added to an accumulator every frame and spent in
+ *    whole simulation steps, so the simulation runs at the same rate
+ *    no matter how fast frames are drawn. What is left over says how
+ *    far we are between the last two steps, which is used to draw the
+ *    lander part way between them. A slow frame can only ask for so
+ *    many steps; the rest of the time is dropped rather than letting
+ *    the catching up make the next frame slow too.
+ ************************************************************************/
+
+#pragma once
+
+#include <chrono>
+
+/***********************************************************
+ * FIXED TIMESTEP
+ * An accumulator of wall time
+ ***********************************************************/
+class FixedTimestep
+{
+public:
+   // stepsPerSecond of wall time, at most maxSteps in one frame
+   FixedTimestep(double stepsPerSecond = 30.0, int maxSteps = 5);
+
+   // how many steps to run this frame, measuring the wall time since
+   // the last call ourselves
+   int beginFrame();
+
+   // how many steps to run for the given wall time, in seconds
+   int advance(double elapsed);
+
+   // how far past the last step we are, in [0, 1). Draw at
+   // previous + alpha * (current - previous)
+   double alpha() const { return accumulator / step; }
+
+   // when the last beginFrame() measured the time. The last step of
+   // that frame ended alpha() steps before this
+   std::chrono::steady_clock::time_point getFrameTime() const { return lastFrame; }
+
+   double getStep()     const { return step;        }  // seconds
+   long   getSteps()    const { return steps;       }  // steps run so far
+   double getDropped()  const { return dropped;     }  // seconds thrown away
+
+private:
+   typedef std::chrono::steady_clock Clock;
+
+   double step;                  // wall time per step, seconds
+   int maxSteps;                 // the most steps in one frame
+   double accumulator;           // wall time not yet spent
+   long steps;
+   double dropped;
+   bool started;                 // has beginFrame() been called?
+   Clock::time_point lastFrame;
+};
+
+/******************************************************************
+ * INTERPOLATE
+ * Part way from a to b
+ ****************************************************************/
+inline double interpolate(double a, double b, double alpha)
+{
+   return a + (b - a) * alpha;
+}
@@ -0,0 +1,139 @@
+/***********************************************************************
+ * Source File:
+ *    Frame Scheduler : Wake up on time for every frame
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Pace frames against the wall clock with steady_clock, sleeping
+ *    for most of the wait and spinning for the last moment.
+ ************************************************************************/
+
+#include "frameScheduler.h"  // for the FrameScheduler class definition
+#include <thread>            // for sleep_until() and yield()
+#include <cassert>
+#include <cmath>             // for sqrt()
+
+const double MIN_SPIN = 0.0002;     // always spin at least this long, seconds
+const double OVERSLEEP_WEIGHT = 0.1; // how fast we learn how late sleep is
+
+/************************************************************************
+ * FRAME STATS constructor
+ ************************************************************************/
+FrameStats::FrameStats() :
+   frames(0), missed(0), meanInterval(0.0), minInterval(0.0), maxInterval(0.0),
+   jitter(0.0), meanLateness(0.0), maxLateness(0.0)
+{
+}
+
+/************************************************************************
+ * FRAME SCHEDULER constructor
+ ************************************************************************/
+FrameScheduler::FrameScheduler(double framesPerSecond) :
+   period(1.0 / framesPerSecond), deadline(Clock::now()), started(false),
+   oversleep(0.001), sumSquares(0.0)
+{
+   assert(framesPerSecond > 0.0);
+}
+
+/************************************************************************
+ * SET FRAMES PER SECOND
+ ************************************************************************/
+void FrameScheduler::setFramesPerSecond(double framesPerSecond)
+{
+   assert(framesPerSecond > 0.0);
+   period = Seconds(1.0 / framesPerSecond);
+}
+
+/************************************************************************
+ * SET NEXT DRAW TIME
+ ************************************************************************/
+void FrameScheduler::setNextDrawTime()
+{
+   deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(period);
+}
+
+/************************************************************************
+ * WAIT FOR NEXT FRAME
+ * Sleep until a little before the deadline, leaving room for how late
+ * the operating system usually wakes us, then spin the rest of the way.
+ * The next deadline is one period after this one, so the frame rate
+ * does not drift. If we are more than a whole period behind, the frame
+ * is counted as missed and the schedule starts over from now rather
+ * than rushing out frames to catch up
+ ************************************************************************/
+void FrameScheduler::waitForNextFrame()
+{
+   const Clock::duration step = std::chrono::duration_cast<Clock::duration>(period);
+
+   // how long to spin: twice the usual oversleep, within reason
+   double spin = 2.0 * oversleep;
+   if (spin < MIN_SPIN)
+      spin = MIN_SPIN;
+   if (spin > period.count() / 2.0)
+      spin = period.count() / 2.0;
+
+   Clock::time_point wake = deadline -
+      std::chrono::duration_cast<Clock::duration>(Seconds(spin));
+   if (Clock::now() < wake)
+   {
+      std::this_thread::sleep_until(wake);
+      double late = Seconds(Clock::now() - wake).count();
+      oversleep += OVERSLEEP_WEIGHT * ((late > 0.0 ? late : 0.0) - oversleep);
+   }
+
+   // the last little bit
+   while (Clock::now() < deadline)
+      std::this_thread::yield();
+
+   Clock::time_point now = Clock::now();
+   record(now);
+
+   deadline += step;
+   if (now >= deadline)
+   {
+      stats.missed++;
+      deadline = now + step;
+   }
+}
+
+/************************************************************************
+ * RECORD
+ * Time one frame against the one before it and against its deadline
+ ************************************************************************/
+void FrameScheduler::record(Clock::time_point now)
+{
+   double lateness = Seconds(now - deadline).count();
+   stats.frames++;
+   stats.meanLateness += (lateness - stats.meanLateness) / stats.frames;
+   if (lateness > stats.maxLateness)
+      stats.maxLateness = lateness;
+
+   if (started)
+   {
+      // Welford's running mean and variance of the interval
+      double interval = Seconds(now - lastFrame).count();
+      long n = stats.frames - 1;
+      double delta = interval - stats.meanInterval;
+      stats.meanInterval += delta / n;
+      sumSquares += delta * (interval - stats.meanInterval);
+      stats.jitter = sqrt(sumSquares / n);
+
+      if (n == 1 || interval < stats.minInterval)
+         stats.minInterval = interval;
+      if (interval > stats.maxInterval)
+         stats.maxInterval = interval;
+   }
+
+   lastFrame = now;
+   started = true;
+}
+
+/************************************************************************
+ * RESET STATS
+ ************************************************************************/
+void FrameScheduler::resetStats()
+{
+   stats = FrameStats();
+   sumSquares = 0.0;
+   started = false;
+}
@@ -0,0 +1,79 @@
+/***********************************************************************
+ * Header File:
+ *    Frame Scheduler : Wake up on time for every frame
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Pace frames against the wall clock with steady_clock. Most of the
+ *    wait is spent asleep so the CPU is free; the last moment before
+ *    the deadline is spent spinning because the operating system often
+ *    wakes us up late. How late it tends to be is learned as we go.
+ *    Every frame is timed so jitter and missed deadlines can be reported.
+ ************************************************************************/
+
+#pragma once
+
+#include <chrono>
+
+/*********************************************
+ * FRAME STATS
+ * How well the frames kept to the schedule.
+ * All times are in seconds
+ *********************************************/
+struct FrameStats
+{
+   FrameStats();
+
+   long   frames;          // frames timed
+   long   missed;          // frames that woke up a whole period late
+   double meanInterval;    // average time from one frame to the next
+   double minInterval;
+   double maxInterval;
+   double jitter;          // standard deviation of the interval
+   double meanLateness;    // how long after the deadline we woke up
+   double maxLateness;
+};
+
+/***********************************************************
+ * FRAME SCHEDULER
+ * Hybrid sleep and spin on a steady clock
+ ***********************************************************/
+class FrameScheduler
+{
+public:
+   typedef std::chrono::steady_clock Clock;
+
+   FrameScheduler(double framesPerSecond = 30.0);
+
+   // change the frame rate. Takes effect from the next frame
+   void setFramesPerSecond(double framesPerSecond);
+   double getPeriod() const { return period.count(); }   // seconds
+
+   // is the deadline for the next frame already here?
+   bool isTimeToDraw() const { return Clock::now() >= deadline; }
+
+   // sleep, then spin, until the deadline. Then time the frame and
+   // set the deadline for the one after
+   void waitForNextFrame();
+
+   // the deadline for the next frame is one period from now
+   void setNextDrawTime();
+
+   // the timing so far
+   const FrameStats & getStats() const { return stats; }
+   void resetStats();
+
+private:
+   typedef std::chrono::duration<double> Seconds;
+
+   void record(Clock::time_point now);
+
+   Seconds period;                  // time between frames
+   Clock::time_point deadline;      // when the next frame is due
+   Clock::time_point lastFrame;     // when the last frame went out
+   bool started;                    // has there been a frame yet?
+
+   double oversleep;                // how late sleep tends to wake us, seconds
+   double sumSquares;               // for the jitter: sum of (interval - mean)^2
+   FrameStats stats;
+};
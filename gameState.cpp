@@ -6,55 +6,228 @@
 //
 
 #include "gameState.hpp"
+#include <cstring>
+#include <cassert>
+#include <type_traits>
 
-gameState::gameState(double a) : crashed(false), landed(false),
-fuel(5000.0), altitude(a), speed(0.0)  {}
+static_assert(sizeof(gameState) == gameState::WORDS * sizeof(uint64_t),
+              "gameState must have no padding");
+static_assert(std::is_trivially_copyable<gameState>::value,
+              "gameState must be copyable with memcpy");
 
-    
-bool gameState::getCrashed()const {
-    return false;
+gameState::gameState(double a) : x(0.0), y(0.0), dx(0.0), dy(0.0), angle(0.0),
+thrust(0.0), altitude(a), speed(0.0), fuel(5000), crashed(false), landed(false),
+spare(0) {}
+
+gameState::gameState(const LanderState & lander, double a, double s) : spare(0) {
+    updateGamestate(lander, a, s);
 }
 
-bool gameState::getLanded()const {
-    return true;
+LanderState gameState::getLander()const {
+    LanderState lander;
+    lander.x = x;
+    lander.y = y;
+    lander.dx = dx;
+    lander.dy = dy;
+    lander.angle = angle;
+    lander.thrust = thrust;
+    lander.fuel = fuel;
+    lander.status = crashed ? CRASHED : (landed ? LANDED : FLYING);
+    return lander;
 }
-bool gameState::getFuel()const {
-    return true;
+
+void gameState::checkCrashed(const LanderState & lander) {
+    crashed = lander.status == CRASHED;
 }
-double gameState::getAltitude()const {
-    return 0.0;
+
+void gameState::checkLanded(const LanderState & lander) {
+    landed = lander.status == LANDED;
 }
-double gameState::getSpeed()const {
-    return 0.0;
+
+void gameState::updateGamestate(const LanderState & lander, double a, double s) {
+    x = lander.x;
+    y = lander.y;
+    dx = lander.dx;
+    dy = lander.dy;
+    angle = lander.angle;
+    thrust = lander.thrust;
+    fuel = lander.fuel;
+    altitude = a;
+    speed = s;
+    checkCrashed(lander);
+    checkLanded(lander);
 }
-bool gameState::setCrashed() {
-    return true;
+
+//
+// GAME HISTORY
+//
+
+gameHistory::gameHistory(long capacity) : oldest(0), numSegments(0),
+cacheStart(-1), cacheCount(0) {
+    assert(capacity > 0);
+    segments.resize((capacity + KEY_INTERVAL - 1) / KEY_INTERVAL + 1);
 }
-bool gameState::setLanded() {
-    return true;
+
+long gameHistory::first()const {
+    assert(!empty());
+    return segments[oldest].start;
 }
-bool gameState::setFuel() {
-    return true;
+
+long gameHistory::last()const {
+    assert(!empty());
+    const segment & seg = segments[(oldest + numSegments - 1) % segments.size()];
+    return seg.start + seg.count - 1;
 }
-double gameState::setAltitude() {
-    return true;
+
+void gameHistory::clear() {
+    oldest = 0;
+    numSegments = 0;
+    cacheStart = -1;
+    cacheCount = 0;
 }
-double gameState::setSpeed() {
-    return true;
+
+// Every segment but the newest is full, so the segment a frame is in can
+// be worked out instead of searched for
+gameHistory::segment * gameHistory::find(long frame) {
+    if (empty() || frame < first() || frame > last())
+        return NULL;
+    size_t i = (size_t)((frame - first()) / KEY_INTERVAL);
+    return &segments[(oldest + i) % segments.size()];
 }
 
-void gameState::checkCrashed() {
-    
+// The changes from one frame to the next. XOR the two as 64-bit words:
+// the top of a double (the sign and exponent) hardly ever changes, so
+// only the low bytes that are not zero are kept. Four bits per word say
+// how many bytes that is, then come the bytes, low byte first
+void gameHistory::encode(const gameState & from, const gameState & to,
+                         std::vector<unsigned char> & out) {
+    uint64_t a[gameState::WORDS];
+    uint64_t b[gameState::WORDS];
+    memcpy(a, &from, sizeof(a));
+    memcpy(b, &to, sizeof(b));
+
+    int lengths[gameState::WORDS];
+    for (int i = 0; i < gameState::WORDS; i++) {
+        uint64_t change = a[i] ^ b[i];
+        lengths[i] = 0;
+        while (lengths[i] < 8 && change >> (8 * lengths[i]))
+            lengths[i]++;
+    }
+
+    for (int i = 0; i < gameState::WORDS; i += 2)
+        out.push_back((unsigned char)(lengths[i] |
+                      (i + 1 < gameState::WORDS ? lengths[i + 1] << 4 : 0)));
+
+    for (int i = 0; i < gameState::WORDS; i++) {
+        uint64_t change = a[i] ^ b[i];
+        for (int j = 0; j < lengths[i]; j++)
+            out.push_back((unsigned char)(change >> (8 * j)));
+    }
 }
-void gameState::checkLanded() {
-    
+
+void gameHistory::apply(const unsigned char *& in, gameState & state) {
+    uint64_t words[gameState::WORDS];
+    memcpy(words, &state, sizeof(words));
+
+    const unsigned char * lengths = in;
+    in += (gameState::WORDS + 1) / 2;
+    for (int i = 0; i < gameState::WORDS; i++) {
+        int length = (lengths[i / 2] >> (4 * (i % 2))) & 0xf;
+        uint64_t change = 0;
+        for (int j = 0; j < length; j++)
+            change |= (uint64_t)*in++ << (8 * j);
+        words[i] ^= change;
+    }
+
+    memcpy(&state, words, sizeof(words));
 }
-void gameState::updateGamestate() {
-    
+
+// Start a new segment with a whole state when the newest is full. When
+// the ring is full that means forgetting the oldest segment
+void gameHistory::push(const gameState & state) {
+    if (empty() || newest().count == KEY_INTERVAL) {
+        long start = empty() ? 0 : last() + 1;
+        if (numSegments == segments.size()) {
+            if (cacheStart == segments[oldest].start)
+                cacheStart = -1;
+            oldest = (oldest + 1) % segments.size();
+            numSegments--;
+        }
+        numSegments++;
+        segment & seg = newest();
+        seg.start = start;
+        seg.count = 1;
+        seg.key = state;
+        seg.deltas.clear();        // keeps its memory for next time
+    }
+    else {
+        segment & seg = newest();
+        seg.offsets[seg.count] = (unsigned short)seg.deltas.size();
+        encode(previous, state, seg.deltas);
+        seg.count++;
+    }
+    previous = state;
 }
-void gameState::getLanded() {
-    
+
+// Decode the frames of a segment that are not in the cache yet
+void gameHistory::decode(segment & seg) {
+    if (cacheStart != seg.start) {
+        cacheStart = seg.start;
+        cacheCount = 0;
+    }
+    if (cacheCount == 0) {
+        cache[0] = seg.key;
+        cacheCount = 1;
+    }
+
+    if (cacheCount == seg.count)
+        return;
+    const unsigned char * in = &seg.deltas[0] + seg.offsets[cacheCount];
+    for (; cacheCount < seg.count; cacheCount++) {
+        cache[cacheCount] = cache[cacheCount - 1];
+        apply(in, cache[cacheCount]);
+    }
 }
-void gameState::getCrashed() {
-    
+
+bool gameHistory::get(long frame, gameState & state) {
+    segment * seg = find(frame);
+    if (seg == NULL)
+        return false;
+    decode(*seg);
+    state = cache[frame - seg->start];
+    return true;
+}
+
+// Drop whole segments after the frame, then cut the one it is in short
+bool gameHistory::rewind(long frames, gameState & state) {
+    if (empty() || frames < 0)
+        return false;
+    long frame = last() - frames;
+    if (frame < first())
+        frame = first();
+
+    while (newest().start > frame) {
+        if (cacheStart == newest().start)
+            cacheStart = -1;
+        numSegments--;
+    }
+
+    segment & seg = newest();
+    int count = (int)(frame - seg.start + 1);
+    if (count < seg.count)
+        seg.deltas.resize(seg.offsets[count]);
+    seg.count = count;
+    if (cacheStart == seg.start && cacheCount > seg.count)
+        cacheCount = seg.count;
+
+    get(frame, state);
+    previous = state;
+    return true;
+}
+
+size_t gameHistory::bytes()const {
+    size_t total = sizeof(*this) + segments.capacity() * sizeof(segment);
+    for (size_t i = 0; i < segments.size(); i++)
+        total += segments[i].deltas.capacity();
+    return total;
 }
@@ -4,39 +4,124 @@
 //
 //  Created by Samuel on 2/1/23.
 //
+//  gameState is everything about one frame of the game in 72 bytes with
+//  no pointers, so it can be copied with memcpy and compared word by
+//  word. gameHistory keeps the recent frames so the game can be rewound
+//  or scrubbed: every KEY_INTERVAL frames a whole state is kept, and the
+//  frames in between only keep the bytes that changed from the frame
+//  before. The history holds a fixed number of frames, so memory stays
+//  the same however long the game runs.
+//
 
 #ifndef gameState_hpp
 #define gameState_hpp
 
 #include <stdio.h>
+#include <vector>
+#include <cstdint>
+#include "simulator.h"
 
 class gameState {
-    
+
 private:
+    double x;               // the lander's position
+    double y;
+    double dx;              // and velocity
+    double dy;
+    double angle;
+    double thrust;
+    double altitude;        // above the ground under it
+    double speed;
+    int fuel;
     bool crashed;
     bool landed;
-    bool fuel;
-    double altitude;
-    double speed;
+    uint16_t spare;         // always zero, so there are no padding bytes
 public:
+    gameState() : gameState(0.0) {}
     gameState(double a);
-    
-    bool getCrashed()const;
-    bool getLanded()const;
-    bool getFuel()const;
-    double getAltitude()const;
-    double getSpeed()const;
-    bool setCrashed();
-    bool setLanded();
-    bool setFuel();
-    double setAltitude();
-    double setSpeed();
-    
-    void checkCrashed();
-    void checkLanded();
-    void updateGamestate();
-    void getLanded();
-    void getCrashed();
+    gameState(const LanderState & lander, double a, double s);
+
+    bool getCrashed()const      { return crashed;  }
+    bool getLanded()const       { return landed;   }
+    int getFuel()const          { return fuel;     }
+    bool hasFuel()const         { return fuel > 0; }
+    double getAltitude()const   { return altitude; }
+    double getSpeed()const      { return speed;    }
+    void setCrashed(bool c)     { crashed = c;     }
+    void setLanded(bool l)      { landed = l;      }
+    void setFuel(int f)         { fuel = f;        }
+    void setAltitude(double a)  { altitude = a;    }
+    void setSpeed(double s)     { speed = s;       }
+
+    // the lander this frame, and the frame after a step
+    LanderState getLander()const;
+    void updateGamestate(const LanderState & lander, double a, double s);
+
+    void checkCrashed(const LanderState & lander);
+    void checkLanded(const LanderState & lander);
+
+    // how many 64-bit words the state is, for the history
+    static const int WORDS = 9;
+};
+
+class gameHistory {
+
+public:
+    static const int KEY_INTERVAL = 32;    // frames from one whole state to the next
+
+    // enough for capacity frames. An hour at 30 frames a second by default
+    gameHistory(long capacity = 30L * 60 * 60);
+
+    // the frame after the last one
+    void push(const gameState & state);
+
+    // the frames still kept are numbered first() to last()
+    bool empty()const { return numSegments == 0; }
+    long first()const;
+    long last()const;
+    long size()const  { return empty() ? 0 : last() - first() + 1; }
+
+    // any frame still kept. Going through the frames in order, either
+    // way, only decodes each group of KEY_INTERVAL frames once
+    bool get(long frame, gameState & state);
+
+    // go back some frames and forget the ones after. The next push()
+    // follows the frame we went back to
+    bool rewind(long frames, gameState & state);
+
+    // everything forgotten
+    void clear();
+
+    // memory in use, in bytes
+    size_t bytes()const;
+
+private:
+    // a whole state and the changes in the frames after it
+    struct segment {
+        long start;                              // the frame of the whole state
+        int count;                               // frames, counting the whole one
+        gameState key;
+        unsigned short offsets[KEY_INTERVAL];    // where each frame's changes start
+        std::vector<unsigned char> deltas;
+    };
+
+    segment & newest() { return segments[(oldest + numSegments - 1) % segments.size()]; }
+    segment * find(long frame);
+    void decode(segment & seg);
+
+    static void encode(const gameState & from, const gameState & to,
+                       std::vector<unsigned char> & out);
+    static void apply(const unsigned char *& in, gameState & state);
+
+    std::vector<segment> segments;   // a ring
+    size_t oldest;                   // the first segment in the ring
+    size_t numSegments;              // in use
+    gameState previous;              // the last frame pushed
+
+    // the segment decoded last
+    long cacheStart;
+    int cacheCount;
+    gameState cache[KEY_INTERVAL];
 };
 
-#endif /* director_hpp */
+#endif /* gameState_hpp */
@@ -6,19 +6,41 @@
 
 // Created by Isaac Radford, Andrew Swayze, Samuel Casellas
 
-#include "physics.h"
 #include "point.h"
 #include "uiInteract.h"
 #include "uiDraw.h"
 #include "ground.h"
+#include "simulator.h"
+#include "fixedTimestep.h"
+#include "frameScheduler.h"
+#include "tripleBuffer.h"
+#include "profiler.h"
+#include "replay.h"
 #include <vector>
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 using namespace std;
 
-const double gravity = -1.625;
-const double thrust = 45000.000;
-const double weight = 15103.000;
-const double tTime = 0.1;
+const double STEPS_PER_SECOND = 30.0;   // physics steps per second of wall time
+const int    MAX_STEPS_PER_FRAME = 5;   // catch up no more than this in one frame
+const int    KEY_BATCH = 32;            // key events taken from the interface at once
+const long   SAVE_EVERY = 150;          // steps between saves of the recording
+
+/*************************************************************************
+ * SNAPSHOT
+ * What the simulation thread hands to the drawing thread after a step
+ *************************************************************************/
+struct Snapshot
+{
+    LanderState previous;  // the lander one step ago
+    LanderState current;   // the lander now
+    LanderInput input;     // the controls used for the step, for the flames
+    double speed;          // how fast the lander is going now
+    chrono::steady_clock::time_point time; // when the step finished
+};
 
 /*************************************************************************
  * Demo
@@ -28,16 +50,29 @@ const double tTime = 0.1;
 class Demo
 {
 public:
-    Demo(const Point &ptUpperRight) : angle(0.0),
+    // the ground comes from the replay's seed. If playing, the keys
+    // come from the replay too; otherwise they are recorded into it and
+    // saved to recordFile, if there is one
+    Demo(const Point &ptUpperRight, const Interface * pUI,
+         Replay & replay, bool playing, const char * recordFile) :
                                       ptStar(ptUpperRight.getX() - 20.0, ptUpperRight.getY() - 20.0),
-                                      ptLM(ptUpperRight.getX() - 100.0, ptUpperRight.getY() - 80.0),
-                                      ptLM2(ptLM),
-                                      ground(ptUpperRight), fuel(5000), altitude(0), speed(0),
-                                      dx(0), dy(0),
-                                      y(ptUpperRight.getY() - 80.0),
-                                      x(ptUpperRight.getX() - 100.0),
-                                      down(gravity)
+                                      ground(ptUpperRight, replay.getSeed()),
+                                      sim(ground),
+                                      timestep(STEPS_PER_SECOND, MAX_STEPS_PER_FRAME),
+                                      pUI(pUI),
+                                      replay(replay),
+                                      playing(playing),
+                                      recordFile(recordFile),
+                                      numEvents(0),
+                                      iEvent(0),
+                                      running(true)
     {
+        replay.rewind();
+
+        lander = sim.start(ptUpperRight);
+        previous = lander;
+        publish(LanderInput());
+
         // create a bunch of stars
         for (int i = 0; i < 49; i++)
         {
@@ -49,37 +84,210 @@ public:
             }
         };
         phase = random(0, 255);
+
+        // the physics runs on its own thread from here on
+        simThread = thread(&Demo::simulate, this);
+    }
+
+    ~Demo()
+    {
+        stop();
+    }
+
+    // stop the simulation thread, wait for it, and save what was
+    // recorded. Safe to call twice
+    void stop()
+    {
+        if (!simThread.joinable())
+            return;
+        running = false;
+        simThread.join();
+        if (!playing && recordFile != NULL)
+            replay.save(recordFile);
     }
 
     // this is just for test purposes.  Don't make member variables public!
-    Point ptLM;  // location of the LM on the screen
-    Point ptLM2; // Location of previous LM on screen
-    int ptLMx;
-    int ptLMy;
-    Point ptUpperRight;  // size of the screen
-    double angle;        // angle the LM is pointing
-    unsigned char phase; // phase of the star's blinking
-    Ground ground;
     Point ptStar;
+    unsigned char phase; // phase of the star's blinking
     vector<Point> stars;
 
-    int fuel;
-    int altitude;
-    double speed;
-    bool gameEnd = false;
-    double dx;
-    double dy;
+    Ground ground;       // what we are landing on. Only read once flying
+    TripleBuffer<Snapshot> snapshots; // the newest step, for drawing
+
+private:
+    void simulate();
+    void publish(const LanderInput & input);
+    LanderInput nextInput(LanderInput & held, bool & space,
+                          chrono::steady_clock::time_point stepEnd);
+
+    // everything below belongs to the simulation thread
+    Simulator sim;       // moves the lander, knows nothing of drawing
+    LanderState lander;  // where the LM is and how it is moving
+    LanderState previous; // the lander one step ago, for drawing in between
+    FixedTimestep timestep; // how many steps each pass gets
+    const Interface * pUI; // where the key events come from
+    Replay & replay;     // every step's keys
+    bool playing;        // are the keys coming from the replay?
+    const char * recordFile; // where to save what was recorded
+
+    KeyEvent events[KEY_BATCH];  // taken from the interface, not yet applied
+    int numEvents;
+    int iEvent;
+
+    atomic<bool> running;
+    thread simThread;
+};
+
+/*************************************
+ * PUBLISH
+ * Hand the newest step to the drawing thread
+ **************************************/
+void Demo::publish(const LanderInput & input)
+{
+    Snapshot & snapshot = snapshots.write();
+    snapshot.previous = previous;
+    snapshot.current = lander;
+    snapshot.input = input;
+    snapshot.speed = sim.getSpeed(lander);
+    snapshot.time = chrono::steady_clock::now();
+    snapshots.publish();
+}
+
+/*************************************
+ * APPLY KEY
+ * Set the control a key event is about
+ **************************************/
+void applyKey(LanderInput & input, const KeyEvent & event)
+{
+    if (event.key == KEY_UP)
+        input.up = event.down;
+    else if (event.key == KEY_LEFT)
+        input.left = event.down;
+    else if (event.key == KEY_RIGHT)
+        input.right = event.down;
+}
 
-    double x;
-    double y;
+/*************************************
+ * NEXT INPUT
+ * The controls for the step that ends at stepEnd.
+ * Only the key events that happened before the
+ * step ended are applied, and a key pressed at
+ * any time during a step counts as down for that
+ * step, so a tap shorter than a step still fires
+ * the thrusters once
+ **************************************/
+LanderInput Demo::nextInput(LanderInput & held, bool & space,
+                            chrono::steady_clock::time_point stepEnd)
+{
+    LanderInput input = held;
+    space = false;
+    for (;;)
+    {
+        if (iEvent == numEvents)
+        {
+            numEvents = pUI->drainKeyEvents(events, KEY_BATCH);
+            iEvent = 0;
+            if (numEvents == 0)
+                break;
+        }
+        const KeyEvent & event = events[iEvent];
+        if (event.time > stepEnd)
+            break;
+        applyKey(held, event);
+        if (event.down)
+        {
+            applyKey(input, event);
+            space = space || event.key == KEY_SPACE;
+        }
+        iEvent++;
+    }
+    return input;
+}
 
-    double down;
+/*************************************
+ * SIMULATE
+ * The simulation thread. Apply the key events,
+ * step, publish, and wait for the next step.
+ * Drawing never holds this up.
+ * Every step's keys go into the replay, or come
+ * out of it when playing one back
+ **************************************/
+void Demo::simulate()
+{
+    FrameScheduler pace(STEPS_PER_SECOND);
+    LanderInput held = { false, false, false }; // what is down right now
+    LanderInput input = held;                   // what the last step used
 
-    void setDown(double d)
+    while (running)
     {
-        down = d;
+        // normally one step, more if this thread fell behind
+        int numSteps = timestep.beginFrame();
+        chrono::duration<double> step(timestep.getStep());
+        chrono::steady_clock::time_point stepEnd = timestep.getFrameTime() -
+            chrono::duration_cast<chrono::steady_clock::duration>(
+                step * (timestep.alpha() + numSteps - 1));
+
+        for (int i = 0; i < numSteps; i++)
+        {
+            bool space;
+            input = nextInput(held, space, stepEnd);
+            stepEnd += chrono::duration_cast<chrono::steady_clock::duration>(step);
+
+            unsigned int keys = 0;
+            if (playing)
+            {
+                // the player's keys are drained above but not used
+                replay.next(keys);
+                input = Replay::unpack(keys);
+            }
+            else if (lander.status == FLYING)
+            {
+                replay.record(Replay::pack(input, space));
+                if (recordFile != NULL && replay.getSteps() % SAVE_EVERY == 0)
+                    replay.save(recordFile);
+            }
+
+            PROFILE_SCOPE("physics");
+            previous = lander;
+            if (sim.step(lander, input) != FLYING && previous.status == FLYING &&
+                !playing && recordFile != NULL)
+                replay.save(recordFile);
+        }
+        if (numSteps > 0)
+            publish(input);
+
+        pace.waitForNextFrame();
     }
-};
+}
+
+/*************************************
+ * REPLAY HEADLESS
+ * Fly a recorded game with no window, as fast
+ * as it will go, and say how it ended
+ **************************************/
+int replayHeadless(const Replay & recorded)
+{
+    Replay replay(recorded);
+    Random rng(replay.getSeed());
+    Ground ground(replay.getUpperRight(), rng);
+
+    Simulator sim(ground);
+    LanderState lander = sim.start(replay.getUpperRight());
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    int steps = replay.simulate(sim, lander);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    const char * status[] = { "flying", "landed", "crashed" };
+    cout << "seed " << replay.getSeed() << ", " << steps << " steps ("
+         << steps / replay.getStepsPerSecond() << " s of play) in "
+         << seconds * 1000.0 << " ms\n";
+    cout << "x " << lander.x << "  y " << lander.y
+         << "  dx " << lander.dx << "  dy " << lander.dy
+         << "  angle " << lander.angle << "  fuel " << lander.fuel
+         << "  " << status[lander.status] << "\n";
+    return 0;
+}
 
 /*************************************
  * All the interesting work happens here, when
@@ -88,113 +296,72 @@ public:
  * engine will wait until the proper amount of
  * time has passed and put the drawing on the screen.
  **************************************/
-
-physics *phys = new physics;
-
 void callBack(const Interface *pUI, void *p)
 {
-    ogstream gout;
+    // record into the frame so it all goes to OpenGL at once
+    ogstream gout(pUI->getFrame());
 
     // the first step is to cast the void pointer into a game object. This
     // is the first step of every single callback function in OpenGL.
 
     Demo *pDemo = (Demo *)p;
 
-    //  1. Compute the net force acting on the Lunar Module: This is equal to the gravitational force acting in the downward direction, minus the force due to the thrusters acting in the upward direction.
-
-    // Compute the horizontal and vertical components of the acceleration
-    double ddxThrust = phys->computeHorizontalComponent(pDemo->angle, phys->getAccelerationThrust());
-    double ddyThrust = phys->computeVerticalComponent(pDemo->angle, phys->getAccelerationThrust());
-    // Compute the total acceleration
-    phys->setDdx(ddxThrust);
-    phys->setDdy(ddyThrust + gravity);
-
-    // move the ship around
-    if (pDemo->gameEnd == false)
-    {
-        if (pDemo->fuel > 0) {
-            if (pUI->isRight())
-            {
-                pDemo->fuel -= 1;
-                pDemo->angle -= 0.06;
-            }
-
-            if (pUI->isLeft())
-            {
-                pDemo->fuel -= 1;
-                pDemo->angle += 0.06;
-            }
-
-            if (pUI->isUp())
-            {
-                pDemo->fuel -= 10;
-                if (pDemo->fuel < 0) pDemo->fuel = 0;
-
-                //  2.  Compute the acceleration of the Lunar Module: The acceleration is given by the net force divided by the mass of the Lunar Module.
-                phys->setAccelerationThrust(phys->computeAcceleration(thrust, weight));
-            }
-            else
-            {
-                phys->setAccelerationThrust(0.0);
-            }
-            // draw the lander's flames (if fuel)
-            gout.drawLanderFlames(pDemo->ptLM, pDemo->angle, pUI->isUp(), pUI->isLeft(), pUI->isRight());
-        }
-        else
-        {
-            phys->setAccelerationThrust(0.0);
-        }
-
-        // Compute the new velocity
-        phys->dx = phys->computeVelocity(phys->dx, phys->getDdx(), tTime);
-        phys->dy = phys->computeVelocity(phys->dy, phys->getDdy(), tTime);
+    // the newest step from the simulation thread. This never waits
+    pDemo->snapshots.update();
+    const Snapshot & snapshot = pDemo->snapshots.read();
+    const LanderState & lander = snapshot.current;
+    const LanderInput & input = snapshot.input;
 
-        //    3, Use the velocity to update the position of the Lunar Module: The position is given by the integral of the velocity with respect to time.
-        pDemo->x = phys->computeDistance(pDemo->x, -phys->dx, phys->getDdx(), tTime);
-        pDemo->y = phys->computeDistance(pDemo->y, phys->dy, phys->getDdy(), tTime);
+    // draw the lander part way between the last two steps
+    double alpha = chrono::duration<double>(chrono::steady_clock::now() - snapshot.time).count() *
+                   STEPS_PER_SECOND;
+    alpha = (alpha > 1.0 ? 1.0 : alpha);
+    Point ptLM(interpolate(snapshot.previous.x, lander.x, alpha),
+               interpolate(snapshot.previous.y, lander.y, alpha));
+    double angle = interpolate(snapshot.previous.angle, lander.angle, alpha);
 
-        pDemo->ptLM.setX(pDemo->x);
-        pDemo->ptLM.setY(pDemo->y);
-
-        pDemo->speed = phys->computeTotalComponent(phys->dx, phys->dy);
-        
-       
-    }
+    // draw the lander's flames (if fuel)
+    if (lander.status == FLYING && lander.fuel > 0)
+        gout.drawLanderFlames(ptLM, angle, input.up, input.left, input.right);
 
     // draw the ground
-    pDemo->ground.draw(gout);
+    {
+        PROFILE_SCOPE("ground");
+        pDemo->ground.draw(gout);
+    }
 
     // draw the lander
-    gout.drawLander(pDemo->ptLM /*position*/, pDemo->angle /*angle*/);
-    
-
-    // Calculate the altitude
-    pDemo->altitude = pDemo->ground.getElevation(pDemo->ptLM);
+    gout.drawLander(ptLM /*position*/, angle /*angle*/);
 
     // put some text on the screen
-    gout.setPosition(Point(20.0, 960.0));
-    gout << "Fuel: " << pDemo->fuel << "\n";
-    gout << "Altitude: " << pDemo->altitude << "\n";
-    gout << "Speed: " << pDemo->speed << "\n";
+    {
+        PROFILE_SCOPE("text");
+        gout.setPosition(Point(20.0, 960.0));
+        gout << "Fuel: " << lander.fuel << "\n";
+        gout << "Altitude: " << (int)pDemo->ground.getElevation(ptLM) << "\n";
+        gout << "Speed: " << snapshot.speed << "\n";
+        gout.flush();
+    }
 
     // draw our little star
-    gout.drawStar(pDemo->ptStar, pDemo->phase++);
+    {
+        PROFILE_SCOPE("stars");
+        gout.drawStar(pDemo->ptStar, pDemo->phase++);
 
-    // draw a bunch of stars
-    for (int i = 0; i < pDemo->stars.size(); i++)
-        gout.drawStar(pDemo->stars[i], pDemo->phase++);
+        // draw a bunch of stars
+        for (int i = 0; i < pDemo->stars.size(); i++)
+            gout.drawStar(pDemo->stars[i], pDemo->phase++);
+    }
 
     // Game over if you run out of fuel.
-    if (pDemo->fuel <= 0)
+    if (lander.fuel <= 0)
     {
         gout.setPosition(Point(130, 140.0));
         gout << "You ran out of fuel!"
              << "\n";
-
-        pDemo->setDown(0);
     }
 
-    if (pDemo->ground.hitGround(pDemo->ptLM, 20))
+    if (lander.status == CRASHED)
     {
         gout.setPosition(Point(160.0, 200.0));
         gout << "Game Over"
@@ -202,29 +369,32 @@ void callBack(const Interface *pUI, void *p)
         gout.setPosition(Point(152.0, 170.0));
         gout << "You crashed!"
              << "\n";
-        pDemo->gameEnd = true;
-        pDemo->setDown(0);
     }
 
-    if (pDemo->ground.onPlatform(pDemo->ptLM, 20.0) && phys->dy <= 4 && phys-> dx <= 2)
+    if (lander.status == LANDED)
     {
         gout.setPosition(Point(137.0, 300.0));
         gout << "You landed safely"
              << "\n";
-        pDemo->gameEnd = true;
-        pDemo->setDown(0);
-    }
-    else if (pDemo->ground.onPlatform(pDemo->ptLM, 20.0) && pDemo->speed > 4)
-    {
-        gout.setPosition(Point(160.0, 200.0));
-        gout << "Game Over"
-             << "\n";
-        gout.setPosition(Point(130.0, 170.0));
-        gout << "You crashed into the ground"
-             << "\n";
-        pDemo->gameEnd = true;
-        pDemo->setDown(0);
     }
+
+#ifdef PROFILE
+    // where the time goes, and a trace of it when P is pressed
+    Profiler::drawOverlay(gout, Point(560.0, 960.0));
+    if (pUI->isP())
+        Profiler::writeTrace("apollo_trace.json");
+#endif // PROFILE
+}
+
+/*************************************
+ * CLOSE BACK
+ * The window is closing and the program will exit
+ * without destroying the demo, so stop it and save
+ * the recording here
+ **************************************/
+void closeBack(void *p)
+{
+    ((Demo *)p)->stop();
 }
 
 /*********************************
@@ -244,17 +414,55 @@ int WINAPI wWinMain(
 int main(int argc, char **argv)
 #endif // !_WIN32
 {
-    // Initialize OpenGL
+#ifdef _WIN32_X
+    int argc = __argc;
+    char ** argv = __argv;
+#endif // _WIN32_X
+
+    // --record FILE saves the game as it is played
+    // --replay FILE plays a saved game back, in the window or, with
+    //               --headless, as fast as possible with no window
+    const char * recordFile = NULL;
+    const char * replayFile = NULL;
+    bool headless = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--record") == 0)
+            recordFile = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--replay") == 0)
+            replayFile = argv[++i];
+        else if (strcmp(argv[i], "--headless") == 0)
+            headless = true;
+    }
+
+    Replay replay;
     Point ptUpperRight(1000.0, 1000.0);
+    if (replayFile != NULL)
+    {
+        if (!replay.load(replayFile))
+        {
+            cerr << "Cannot read the replay " << replayFile << "\n";
+            return 1;
+        }
+        if (headless)
+            return replayHeadless(replay);
+        ptUpperRight = replay.getUpperRight();
+    }
+
+    // Initialize OpenGL
     Interface ui(0, NULL,
                  "Open GL Demo",
                  ptUpperRight);
 
+    // a new game gets a new ground
+    if (replayFile == NULL)
+        replay.start(threadRandom().next(), ptUpperRight, STEPS_PER_SECOND);
+
     // Initialize the game class
-    Demo demo(ptUpperRight);
+    Demo demo(ptUpperRight, &ui, replay, replayFile != NULL, recordFile);
 
     // set everything into action
-    ui.run(callBack, &demo);
+    ui.run(callBack, &demo, closeBack);
 
     return 0;
 }
@@ -8,41 +8,150 @@
  ************************************************************************/
 
 #include "ground.h"   // for the Ground class definition
-#include "uiDraw.h"   // for random() and drawLine()
+#include "uiDraw.h"   // for drawLine()
 #include <cassert>
+#include <cmath>      // for floor()
+#include <cstdio>     // for fopen()
+#include <cstring>    // for memcmp()
+#include <climits>    // for INT_MAX
+#include <vector>
+#include <algorithm>  // for std::copy()
 
 const int    LZ_SIZE = 30;
 const double MAX_SLOPE = 2.7; // steapness of the features. Smaller number is flatter
 const double LUMPINESS = 1.0; // size of the hills. Smaller number is bigger features
 const double TEXTURE = 3.0;   // size of the small features such as rocks
 
+/*********************************************
+ * TERRAIN HEADER
+ * The start of a saved ground. The sections
+ * that follow are each aligned to 64 bytes:
+ *    the landing zone table  int64_t[numLZ]
+ *    the elevations          double[width]
+ *    the range-max tables    double[indexSize]
+ * Everything is in the byte order of the
+ * machine that wrote it. A machine with the
+ * other byte order refuses the file
+ *********************************************/
+struct TerrainHeader
+{
+   char     magic[8];          // "APOLLOGR"
+   uint32_t version;           // TERRAIN_VERSION
+   uint32_t byteOrder;         // TERRAIN_BYTE_ORDER, as written
+   uint64_t width;             // number of columns
+   double   height;            // the height of the world
+   uint64_t seed;              // the seed the ground was made from
+   uint64_t numLZ;             // entries in the landing zone table
+   uint64_t lzOffset;          // where each section starts, in bytes
+   uint64_t elevationOffset;
+   uint64_t indexOffset;
+   uint64_t indexSize;         // number of doubles in the range-max tables
+   uint64_t fileSize;          // the whole file, in bytes
+};
+
+const char     TERRAIN_MAGIC[8] = { 'A', 'P', 'O', 'L', 'L', 'O', 'G', 'R' };
+const uint32_t TERRAIN_VERSION = 1;
+const uint32_t TERRAIN_BYTE_ORDER = 0x01020304;
+const uint64_t TERRAIN_ALIGN = 64;
+
+// drawRectangle() records a quad, which the DrawBuffer splits into two
+// triangles. This is how many vertices every column takes in the layer
+const int VERTICES_PER_COLUMN = 6;
+
+/************************************************************************
+ * ALIGN UP
+ * Round an offset up to the next section boundary
+ ************************************************************************/
+static inline uint64_t alignUp(uint64_t offset)
+{
+   return (offset + TERRAIN_ALIGN - 1) / TERRAIN_ALIGN * TERRAIN_ALIGN;
+}
+
  /************************************************************************
   * GROUND constructor
   * Create a new ground object
   ************************************************************************/
-Ground::Ground(const Point & ptUpperRight) : ptUpperRight(ptUpperRight)
+Ground::Ground(const Point & ptUpperRight) :
+   ground(NULL), owned(NULL), iLZ(0), ptUpperRight(ptUpperRight), seed(0),
+   dirtyMin(0), dirtyMax(-1)
 {
    assert(ptUpperRight.getX() > 0.0);
    assert(ptUpperRight.getY() > 0.0);
 
-   // allocate the array
-   ground = new double[(int)ptUpperRight.getX()];
-
    reset();
 }
 
+/************************************************************************
+ * GROUND constructor
+ * Create a new ground from the given random stream
+ ************************************************************************/
+Ground::Ground(const Point & ptUpperRight, Random & rng) :
+   ground(NULL), owned(NULL), iLZ(0), ptUpperRight(ptUpperRight), seed(0),
+   dirtyMin(0), dirtyMax(-1)
+{
+   assert(ptUpperRight.getX() > 0.0);
+   assert(ptUpperRight.getY() > 0.0);
+
+   reset(rng);
+}
+
+/************************************************************************
+ * GROUND constructor
+ * Create a new ground from a seed
+ ************************************************************************/
+Ground::Ground(const Point & ptUpperRight, uint64_t seed) :
+   ground(NULL), owned(NULL), iLZ(0), ptUpperRight(ptUpperRight), seed(0),
+   dirtyMin(0), dirtyMax(-1)
+{
+   assert(ptUpperRight.getX() > 0.0);
+   assert(ptUpperRight.getY() > 0.0);
+
+   Random rng(seed);
+   reset(rng);
+}
+
+/************************************************************************
+ * GROUND constructor
+ * Load a saved ground
+ ************************************************************************/
+Ground::Ground(const char * fileName) :
+   ground(NULL), owned(NULL), iLZ(0), ptUpperRight(0.0, 0.0), seed(0),
+   dirtyMin(0), dirtyMax(-1)
+{
+   load(fileName);
+}
+
 /************************************************************************
  * RESET
  * Create a new ground
  ************************************************************************/
- void Ground :: reset()
+void Ground :: reset()
+{
+   reset(threadRandom());
+}
+
+/************************************************************************
+ * RESET
+ * Create a new ground from the given random stream
+ ************************************************************************/
+ void Ground :: reset(Random & rng)
  {
+   assert(ptUpperRight.getX() > 0.0);
+
+   // a loaded ground is read-only, so go back to our own array
+   if (owned == NULL)
+   {
+      file.close();
+      owned = new double[(int)ptUpperRight.getX()];
+   }
+   ground = owned;
+
    // determine the landing location
-   iLZ = (int)random(ptUpperRight.getX() * 0.1, 
-                     ptUpperRight.getX() * 0.9 - (double)LZ_SIZE);
+   iLZ = (int)rng.nextDouble(ptUpperRight.getX() * 0.1, 
+                             ptUpperRight.getX() * 0.9 - (double)LZ_SIZE);
 
    // give each location on the ground an elevation
-   ground[0] = ptUpperRight.getY() / 4.0; // the initial elevation is in the middle.
+   owned[0] = ptUpperRight.getY() / 4.0; // the initial elevation is in the middle.
    double dy = 0.0;         // the initial slope is heavily biased to up
    for (int i = 1; i < int(ptUpperRight.getX()); i++)
    {
@@ -50,18 +159,18 @@ Ground::Ground(const Point & ptUpperRight) : ptUpperRight(ptUpperRight)
       if (i >= iLZ && i < iLZ + LZ_SIZE)
       {
          // the landing zone (LZ) is flat
-         ground[i] = ground[i - 1];
+         owned[i] = owned[i - 1];
       }
       // otherwise, vary the slope
       else
       {
          // 0% is the bottom - favor sloping up to avoid the bottom
          // 100% is the top - favor sloping down to avoid the top
-         double percent = ground[i - 1] / (ptUpperRight.getY() / 2.0) * 0.5;
+         double percent = owned[i - 1] / (ptUpperRight.getY() / 2.0) * 0.5;
 
          // dy is the slope. positive is up, negative is down
-         dy += random(LUMPINESS * (0.25 - percent),
-                      LUMPINESS * (0.75 - percent));
+         dy += rng.nextDouble(LUMPINESS * (0.25 - percent),
+                              LUMPINESS * (0.75 - percent));
 
          // make sure the slop is not too steep
          if (dy > MAX_SLOPE)
@@ -70,30 +179,445 @@ Ground::Ground(const Point & ptUpperRight) : ptUpperRight(ptUpperRight)
             dy = -MAX_SLOPE;
 
          // determine the elevation according to the slope
-         ground[i] = ground[i - 1] + dy + random(-TEXTURE, TEXTURE);
+         owned[i] = owned[i - 1] + dy + rng.nextDouble(-TEXTURE, TEXTURE);
       }
    }
+
+   // index the new ground for hitGround()
+   index.build(ground, (int)ptUpperRight.getX());
+
+   // all of it has to be drawn again
+   markDirty(0, (int)ptUpperRight.getX() - 1);
+}
+
+/************************************************************************
+ * SET ELEVATION
+ * Change part of the ground, such as for a crater
+ ************************************************************************/
+void Ground::setElevation(int xMin, int xMax, const double * elevations)
+{
+   const int width = (int)ptUpperRight.getX();
+   assert(0 <= xMin && xMin <= xMax && xMax < width);
+   assert(elevations != NULL);
+
+   // a loaded ground is read-only, so copy it out first
+   if (owned == NULL)
+   {
+      owned = new double[width];
+      std::copy(ground, ground + width, owned);
+      ground = owned;
+      file.close();
+   }
+
+   std::copy(elevations, elevations + (xMax - xMin + 1), owned + xMin);
+   index.build(ground, width);
+
+   // add to what is already waiting to be drawn
+   if (dirtyMin > dirtyMax)
+      markDirty(xMin, xMax);
+   else
+      markDirty(std::min(dirtyMin, xMin), std::max(dirtyMax, xMax));
+}
+
+/************************************************************************
+ * SAVE
+ * Write the header, the landing zone, the elevations, and the index
+ * tables so load() can use them exactly as they sit on disk
+ ************************************************************************/
+bool Ground::save(const char * fileName, uint64_t seed) const
+{
+   assert(fileName != NULL);
+   if (ground == NULL)
+      return false;
+
+   const uint64_t width = (uint64_t)ptUpperRight.getX();
+
+   TerrainHeader header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, TERRAIN_MAGIC, sizeof(header.magic));
+   header.version         = TERRAIN_VERSION;
+   header.byteOrder       = TERRAIN_BYTE_ORDER;
+   header.width           = width;
+   header.height          = ptUpperRight.getY();
+   header.seed            = seed;
+   header.numLZ           = 1;
+   header.lzOffset        = alignUp(sizeof(header));
+   header.elevationOffset = alignUp(header.lzOffset + header.numLZ * sizeof(int64_t));
+   header.indexSize       = RangeMax::tableSize((int)width);
+   header.indexOffset     = alignUp(header.elevationOffset + width * sizeof(double));
+   header.fileSize        = header.indexOffset + header.indexSize * sizeof(double);
+
+   FILE * fout = fopen(fileName, "wb");
+   if (fout == NULL)
+      return false;
+
+   const char padding[TERRAIN_ALIGN] = {};
+   const int64_t lz = iLZ;
+   bool ok = fwrite(&header, sizeof(header), 1, fout) == 1;
+
+   uint64_t written = sizeof(header);
+   ok = ok && fwrite(padding, 1, header.lzOffset - written, fout) ==
+              header.lzOffset - written;
+   ok = ok && fwrite(&lz, sizeof(lz), 1, fout) == 1;
+
+   written = header.lzOffset + sizeof(lz);
+   ok = ok && fwrite(padding, 1, header.elevationOffset - written, fout) ==
+              header.elevationOffset - written;
+   ok = ok && fwrite(ground, sizeof(double), width, fout) == width;
+
+   written = header.elevationOffset + width * sizeof(double);
+   ok = ok && fwrite(padding, 1, header.indexOffset - written, fout) ==
+              header.indexOffset - written;
+   ok = ok && fwrite(index.getTables(), sizeof(double), header.indexSize, fout) ==
+              header.indexSize;
+
+   ok = (fclose(fout) == 0) && ok;
+   if (!ok)
+      remove(fileName);
+   return ok;
+}
+
+/************************************************************************
+ * IN FILE
+ * Do count items of size bytes starting at offset fit in the file? The
+ * numbers come from the file, so they are compared by division: a
+ * product or a sum of them could wrap around and look small
+ ************************************************************************/
+static inline bool inFile(uint64_t offset, uint64_t count, uint64_t size,
+                          uint64_t fileSize)
+{
+   return offset <= fileSize && count <= (fileSize - offset) / size;
+}
+
+/************************************************************************
+ * LOAD
+ * Map a saved ground and point straight into it. Only the header is
+ * checked; the elevations and the index are not touched until a query
+ * needs them, so a huge world opens as fast as a small one
+ ************************************************************************/
+bool Ground::load(const char * fileName)
+{
+   assert(fileName != NULL);
+
+   MappedFile candidate;
+   if (!candidate.open(fileName) || candidate.size() < sizeof(TerrainHeader))
+      return false;
+
+   const char * base = (const char *)candidate.data();
+   const TerrainHeader & header = *(const TerrainHeader *)base;
+
+   // is this a ground file we understand?
+   if (memcmp(header.magic, TERRAIN_MAGIC, sizeof(header.magic)) != 0 ||
+       header.version != TERRAIN_VERSION ||
+       header.byteOrder != TERRAIN_BYTE_ORDER ||
+       header.fileSize != candidate.size())
+      return false;
+
+   // are the sections where they say they are?
+   if (header.width == 0 || header.width > (uint64_t)INT_MAX ||
+       header.height <= 0.0 || header.numLZ == 0 ||
+       header.lzOffset % sizeof(int64_t) != 0 ||
+       header.elevationOffset % sizeof(double) != 0 ||
+       header.indexOffset % sizeof(double) != 0 ||
+       header.indexSize != RangeMax::tableSize((int)header.width) ||
+       !inFile(header.lzOffset, header.numLZ, sizeof(int64_t), header.fileSize) ||
+       !inFile(header.elevationOffset, header.width, sizeof(double), header.fileSize) ||
+       !inFile(header.indexOffset, header.indexSize, sizeof(double), header.fileSize))
+      return false;
+
+   // only one landing zone is used for now
+   const int64_t lz = *(const int64_t *)(base + header.lzOffset);
+   if (lz < 0 || lz >= (int64_t)header.width)
+      return false;
+
+   // everything checks out: let go of the old ground and use the new one
+   delete [] owned;
+   owned = NULL;
+   file.close();
+   file.swap(candidate);
+
+   base = (const char *)file.data();
+   ground = (const double *)(base + header.elevationOffset);
+   index.attach(ground, (int)header.width,
+                (const double *)(base + header.indexOffset));
+   iLZ = (int)lz;
+   ptUpperRight = Point((double)header.width, header.height);
+   seed = header.seed;
+   markDirty(0, (int)header.width - 1);
+   return true;
 }
 
 /***********************************************************
- * HTI GROUND
- * Did the lander hit the ground?
+ * FOOTPRINT
+ * Which columns are under the lander?
  **********************************************************/
-bool Ground::hitGround(const Point& position, int landerWidth) const
+bool Ground::footprint(const Point & position, int landerWidth,
+                       int & xMin, int & xMax) const
 {
    // find the extent of the lander
-   int xMin = (int)(position.getX() - (double)landerWidth / 2.0);
-   int xMax = (int)(position.getX() + (double)landerWidth / 2.0);
+   xMin = (int)(position.getX() - (double)landerWidth / 2.0);
+   xMax = (int)(position.getX() + (double)landerWidth / 2.0);
 
    xMin = (xMin < 0 ? 0 : xMin);
    xMax = (xMax > (int)ptUpperRight.getX() - 1 ? (int)ptUpperRight.getX() - 1 :  xMax);
 
-   double maxElevation = ground[xMin];
-   for (int i = xMin + 1; i <= xMax; i++)
-      if (ground[i] > maxElevation)
-         maxElevation = ground[i];
+   // there is no ground off the edge of the world
+   return xMin <= xMax;
+}
 
-   return position.getY() < maxElevation;
+/***********************************************************
+ * HTI GROUND
+ * Did the lander hit the ground?
+ **********************************************************/
+bool Ground::hitGround(const Point& position, int landerWidth) const
+{
+   int xMin;
+   int xMax;
+   if (!footprint(position, landerWidth, xMin, xMax))
+      return false;
+
+   return position.getY() < index.max(xMin, xMax);
+}
+
+/***********************************************************
+ * COLUMNS
+ * Column c is the ground from c to c + 1
+ **********************************************************/
+bool Ground::columns(double x0, double x1, int & xMin, int & xMax) const
+{
+   double width = ptUpperRight.getX();
+   double xLow = std::min(x0, x1);
+   double xHigh = std::max(x0, x1);
+   if (ground == NULL || xHigh < 0.0 || xLow >= width)
+      return false;
+   xMin = std::max(0, (int)floor(xLow));
+   xMax = std::min((int)width - 1, (int)floor(xHigh));
+   return true;
+}
+
+/***********************************************************
+ * HIT GROUND
+ * Did the outline of the lander hit the ground? The box
+ * around the lander is tried first, then the box around
+ * each segment, and only then the columns under a segment
+ **********************************************************/
+bool Ground::hitGround(const LanderShape & lander) const
+{
+   int xMin;
+   int xMax;
+   if (!columns(lander.getLeft(), lander.getRight(), xMin, xMax) ||
+       lander.getBottom() >= index.max(xMin, xMax))
+      return false;
+
+   for (int i = 0; i < lander.getNumSegments(); i++)
+      if (segmentHit(lander.getStart(i), lander.getEnd(i)))
+         return true;
+   return false;
+}
+
+/***********************************************************
+ * SEGMENT HIT
+ * Across each column the segment is lowest at one side or
+ * the other, so two points per column are enough
+ **********************************************************/
+bool Ground::segmentHit(const Point & start, const Point & end) const
+{
+   int xMin;
+   int xMax;
+   double yLow = std::min(start.getY(), end.getY());
+   if (!columns(start.getX(), end.getX(), xMin, xMax) ||
+       yLow >= index.max(xMin, xMax))
+      return false;
+
+   double dx = end.getX() - start.getX();
+   double dy = end.getY() - start.getY();
+   if (dx == 0.0)
+      return yLow < ground[xMin];
+
+   double x0 = std::min(start.getX(), end.getX());
+   double x1 = std::max(start.getX(), end.getX());
+   for (int c = xMin; c <= xMax; c++)
+   {
+      double left = std::max(x0, (double)c);
+      double right = std::min(x1, (double)(c + 1));
+      double yLeft = start.getY() + dy * (left - start.getX()) / dx;
+      double yRight = start.getY() + dy * (right - start.getX()) / dx;
+      if (std::min(yLeft, yRight) < ground[c])
+         return true;
+   }
+   return false;
+}
+
+/***********************************************************
+ * ON PLATFORM
+ * Both feet over the platform and within a pixel of it,
+ * with nothing else in the ground
+ **********************************************************/
+bool Ground::onPlatform(const LanderShape & lander) const
+{
+   if (empty())
+      return false;
+
+   const Point * feet[] = { &lander.getLeftFoot(), &lander.getRightFoot() };
+   for (int i = 0; i < 2; i++)
+   {
+      double x = feet[i]->getX();
+      if (x < (double)iLZ || x >= (double)(iLZ + LZ_SIZE))
+         return false;
+      double elevation = getElevation(*feet[i]);
+      if (elevation < 0.0 || elevation > 1.0)
+         return false;
+   }
+   return !hitGround(lander);
+}
+
+/***********************************************************
+ * SWEEP
+ * A lander's footprint moving in a straight line. Column c
+ * is under the footprint while x - w/2 < c + 1 and
+ * x + w/2 >= c, and the footprint moves at a steady rate,
+ * so each run of columns is under it for one span of time
+ **********************************************************/
+struct Ground::Sweep
+{
+   double x0;
+   double y0;
+   double dx;               // over the whole sweep
+   double dy;
+   double half;             // half the width of the lander
+
+   double y(double t) const { return y0 + dy * t; }
+
+   // when are columns [lo, hi] under the footprint? False if never.
+   // Like footprint(), a lander hanging a little off the left edge
+   // is still over column 0
+   bool span(int lo, int hi, double & tEnter, double & tLeave) const
+   {
+      double left = (lo == 0 ? -1.0 : (double)lo) - half;
+      double right = (double)(hi + 1) + half;
+      if (dx == 0.0)
+      {
+         tEnter = 0.0;
+         tLeave = 1.0;
+         return x0 >= left && x0 < right;
+      }
+      double tLeft = (left - x0) / dx;
+      double tRight = (right - x0) / dx;
+      tEnter = std::max(0.0, std::min(tLeft, tRight));
+      tLeave = std::min(1.0, std::max(tLeft, tRight));
+      return tEnter <= tLeave;
+   }
+};
+
+/***********************************************************
+ * SWEPT HIT
+ * Did the lander go into the ground between two positions?
+ **********************************************************/
+bool Ground::sweptHit(const Point & from, const Point & to, int landerWidth,
+                      double & t, int & column) const
+{
+   if (ground == NULL)
+      return false;
+
+   Sweep s;
+   s.x0 = from.getX();
+   s.y0 = from.getY();
+   s.dx = to.getX() - from.getX();
+   s.dy = to.getY() - from.getY();
+   s.half = (double)landerWidth / 2.0;
+
+   // every column the footprint passes over, on the world
+   double width = ptUpperRight.getX();
+   double xLow = std::min(from.getX(), to.getX()) - s.half;
+   double xHigh = std::max(from.getX(), to.getX()) + s.half;
+   if (xHigh <= -1.0 || xLow >= width)
+      return false;
+   int xMin = std::max(0, (int)floor(xLow));
+   int xMax = std::min((int)width - 1, std::max(0, (int)floor(xHigh)));
+
+   double tFirst = 2.0;
+   sweep(s, xMin, xMax, tFirst, column);
+   if (tFirst > 1.0)
+      return false;
+   t = tFirst;
+   return true;
+}
+
+/***********************************************************
+ * SWEEP
+ * Skip any run of columns the lander is above all the
+ * time it is over them, or that it only gets to after a
+ * touch already found. Split the rest, looking first at
+ * the half the lander gets to first
+ **********************************************************/
+void Ground::sweep(const Sweep & s, int lo, int hi, double & tFirst, int & column) const
+{
+   double tEnter;
+   double tLeave;
+   if (!s.span(lo, hi, tEnter, tLeave) || tEnter >= tFirst)
+      return;
+
+   // the lander moves in a straight line, so it is lowest at one end
+   double highest = index.max(lo, hi);
+   if (std::min(s.y(tEnter), s.y(tLeave)) >= highest)
+      return;
+
+   if (lo < hi)
+   {
+      int middle = lo + (hi - lo) / 2;
+      if (s.dx >= 0.0)
+      {
+         sweep(s, lo, middle, tFirst, column);
+         sweep(s, middle + 1, hi, tFirst, column);
+      }
+      else
+      {
+         sweep(s, middle + 1, hi, tFirst, column);
+         sweep(s, lo, middle, tFirst, column);
+      }
+      return;
+   }
+
+   // a single column: in it already, or the moment the lander gets
+   // down to its top
+   double t = tEnter;
+   if (s.y(tEnter) >= highest)
+      t = (highest - s.y0) / s.dy;      // dy < 0, or it would not get lower
+   if (t < tFirst)
+   {
+      tFirst = t;
+      column = lo;
+   }
+}
+
+/***********************************************************
+ * HIT GROUND
+ * Did these landers hit the ground? The footprints are
+ * worked out first, then all handed to the index at once
+ **********************************************************/
+void Ground::hitGround(const Point * positions, int num, int landerWidth,
+                       bool * hits) const
+{
+   assert(num >= 0);
+   if (num == 0)
+      return;
+
+   std::vector<int> xMin(num);
+   std::vector<int> xMax(num);
+   std::vector<double> maxElevation(num);
+   std::vector<bool> onWorld(num);
+
+   for (int i = 0; i < num; i++)
+   {
+      onWorld[i] = footprint(positions[i], landerWidth, xMin[i], xMax[i]);
+      if (!onWorld[i])
+         xMin[i] = xMax[i] = 0;
+   }
+
+   index.max(&xMin[0], &xMax[0], &maxElevation[0], num);
+
+   for (int i = 0; i < num; i++)
+      hits[i] = onWorld[i] && positions[i].getY() < maxElevation[i];
 }
 
 /************************************************************************
@@ -102,6 +626,10 @@ bool Ground::hitGround(const Point& position, int landerWidth) const
  ************************************************************************/
 bool Ground :: onPlatform(const Point & position, int landerWidth) const
 {
+   // there is no platform on an empty world
+   if (empty())
+      return false;
+
    // not on the platform if we are too high
    if (getElevation(position) > 1.0)
       return false;
@@ -122,20 +650,78 @@ bool Ground :: onPlatform(const Point & position, int landerWidth) const
 }
 
 /*****************************************************************
- * DRAW
- * Draw the ground on the screen
+ * DRAW COLUMNS
+ * Record the columns [xMin, xMax]
  ****************************************************************/
-void Ground::draw(ogstream & gout) const
+void Ground::drawColumns(ogstream & gout, int xMin, int xMax) const
 {
-   // iterate through the entire ground and draw it all
-   for (int i = 0; i < (int)ptUpperRight.getX(); i++)
+   for (int i = xMin; i <= xMax; i++)
       gout.drawRectangle(Point((double)i, 0.0), 
                          Point((double)(i + 1), ground[i]), 
                          0.3 /*red*/, 0.2 /*green*/, 0.1 /*blue*/);
+}
 
-   // draw the landing pad
+/*****************************************************************
+ * DRAW PAD
+ * Record the landing pad
+ ****************************************************************/
+void Ground::drawPad(ogstream & gout) const
+{
    gout.drawRectangle(Point((double)iLZ, ground[iLZ]),
                       Point((double)(iLZ + LZ_SIZE), ground[iLZ] - 2.0),
                       0.0 /*red*/, 0.0 /*green*/, 1.0 /*blue*/);
+}
+
+/*****************************************************************
+ * UPDATE LAYER
+ * Bring the layer up to date. The first time every column is
+ * recorded, followed by the pad. After that only the dirty
+ * columns are recorded again and written over the old ones, and
+ * the pad in case it moved
+ ****************************************************************/
+void Ground::updateLayer() const
+{
+   if (dirtyMin > dirtyMax)
+      return;
+
+   const int width = (int)ptUpperRight.getX();
+   if (layer.numVertices() != VERTICES_PER_COLUMN * (width + 1))
+   {
+      layer.clear();
+      ogstream gout(&layer);
+      drawColumns(gout, 0, width - 1);
+      drawPad(gout);
+   }
+   else
+   {
+      DrawBuffer columns;
+      DrawBuffer pad;
+      {
+         ogstream gout(&columns);
+         drawColumns(gout, dirtyMin, dirtyMax);
+      }
+      {
+         ogstream gout(&pad);
+         drawPad(gout);
+      }
+      layer.overwrite(VERTICES_PER_COLUMN * dirtyMin, columns);
+      layer.overwrite(VERTICES_PER_COLUMN * width, pad);
+   }
+
+   dirtyMin = 0;
+   dirtyMax = -1;
+}
+
+/*****************************************************************
+ * DRAW
+ * Draw the ground on the screen
+ ****************************************************************/
+void Ground::draw(ogstream & gout) const
+{
+   // nothing to draw if the file did not load
+   if (ground == NULL)
+      return;
 
+   updateLayer();
+   gout.drawLayer(layer);
 }
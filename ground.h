@@ -11,6 +11,10 @@
 
 #include "point.h"   // for Point
 #include "uiDraw.h"  // for ogstream
+#include "rng.h"     // for Random
+#include "rangeMax.h" // for the elevation index
+#include "mappedFile.h" // for loading a saved ground
+#include "landerGeometry.h" // for the shape of the lander
 
 
  /***********************************************************
@@ -23,10 +27,42 @@ public:
    // the constructor generates the ground
    Ground(const Point & ptUpperRight);
 
-   // reset the game
+   // generate the ground from a given stream, the same as reset(rng)
+   Ground(const Point & ptUpperRight, Random & rng);
+
+   // generate the ground from a stream of its own, made from seed
+   Ground(const Point & ptUpperRight, uint64_t seed);
+
+   // load a saved ground. If the file cannot be loaded, the ground is
+   // empty and there is nothing to hit
+   Ground(const char * fileName);
+   ~Ground() { delete [] owned; }
+
+   // reset the game using this thread's random stream
    void reset();
 
-   // draw the ground on the screen
+   // reset the game from a given stream, so the same seed
+   // always makes the same ground
+   void reset(Random & rng);
+
+   // write the ground to a file that load() can map back in
+   bool save(const char * fileName, uint64_t seed = 0) const;
+
+   // map a saved ground straight from disk: no copy and no parsing.
+   // False if the file is missing or not a ground file
+   bool load(const char * fileName);
+
+   // the size of the world and the seed it was saved with
+   const Point & getUpperRight() const { return ptUpperRight; }
+   uint64_t getSeed()            const { return seed;         }
+   bool empty()                  const { return ground == NULL; }
+
+   // change the elevation of columns [xMin, xMax]. Only those columns
+   // are drawn again
+   void setElevation(int xMin, int xMax, const double * elevations);
+
+   // draw the ground on the screen. The ground is recorded once into a
+   // layer and the layer is reused until the ground changes
    void draw(ogstream & gout) const;
 
    // determine how high the Point is off the ground
@@ -44,8 +80,64 @@ public:
    // hit the ground
    bool hitGround(const Point& position, int landerWidth) const;
 
+   // the same two tests with the lander's real outline at its angle,
+   // rather than a level box. On the platform means both feet are over
+   // it and no more than a pixel above it
+   bool hitGround(const LanderShape & lander) const;
+   bool onPlatform(const LanderShape & lander) const;
+
+   // did the lander hit the ground anywhere on the straight line from
+   // one position to the next? If so, t is how far along the line it
+   // first touched (0 at from, 1 at to) and column is the column it
+   // touched. Only the parts of the ground that could be in the way
+   // are looked at, so a long sweep costs little more than a short one
+   bool sweptHit(const Point & from, const Point & to, int landerWidth,
+                 double & t, int & column) const;
+
+   // hit the ground, for many landers at once
+   void hitGround(const Point * positions, int num, int landerWidth,
+                  bool * hits) const;
+
+   // the highest elevation between two columns, inclusive
+   double maxElevation(int xMin, int xMax) const
+   {
+      return index.max(xMin, xMax);
+   }
+
 private:
-   double * ground;               // the ground array, expressed in elevation 
+   Ground(const Ground &);              // not copyable
+   Ground & operator = (const Ground &);
+
+   // the columns under a lander, or false if it is off the world
+   bool footprint(const Point & position, int landerWidth,
+                  int & xMin, int & xMax) const;
+
+   // does a line segment go into the ground?
+   bool segmentHit(const Point & start, const Point & end) const;
+
+   // the columns from x0 to x1 that are on the world. False if none
+   bool columns(double x0, double x1, int & xMin, int & xMax) const;
+
+   // the first touch in columns [lo, hi] of a sweep that is earlier
+   // than tFirst
+   struct Sweep;
+   void sweep(const Sweep & s, int lo, int hi, double & tFirst, int & column) const;
+
+   // the columns need to be drawn again
+   void markDirty(int xMin, int xMax) { dirtyMin = xMin; dirtyMax = xMax; }
+   void updateLayer() const;
+   void drawColumns(ogstream & gout, int xMin, int xMax) const;
+   void drawPad(ogstream & gout) const;
+
+   const double * ground;         // the ground array, expressed in elevation 
+   double * owned;                // the ground when we generated it ourselves
+   MappedFile file;               // the ground when it was loaded
+   RangeMax index;                // highest elevation over any range of columns
    int    iLZ;                    // the left-most location of the landing zone (LZ)
    Point ptUpperRight;            // the width and height of the world
+   uint64_t seed;                 // the seed the ground was saved with
+
+   mutable DrawBuffer layer;      // the ground, already recorded
+   mutable int dirtyMin;          // the columns that changed since then
+   mutable int dirtyMax;
 };
@@ -0,0 +1,207 @@
+/***********************************************************************
+ * Source File:
+ *    Integrator : Move a body through time under an acceleration
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Euler, Verlet, Runge-Kutta and adaptive Dormand-Prince steps.
+ ************************************************************************/
+
+#include "integrator.h"  // for the Integrator class definition
+#include <cmath>         // for fabs() and pow()
+#include <cassert>
+
+const double SAFETY     = 0.9;   // aim a little under the tolerance
+const double MIN_GROWTH = 0.2;   // the most a step shrinks after a try
+const double MAX_GROWTH = 5.0;   // the most it grows after a good step
+
+/************************************************************************
+ * DERIVATIVE
+ * How fast every part of the motion is changing
+ ************************************************************************/
+static Motion derivative(const Motion & m, Acceleration accel, void * p)
+{
+   Motion d;
+   d.x = m.vx;
+   d.y = m.vy;
+   accel(m, d.vx, d.vy, p);
+   return d;
+}
+
+/************************************************************************
+ * COMBINE
+ * m + h * (a[0] k[0] + a[1] k[1] + ...)
+ ************************************************************************/
+static Motion combine(const Motion & m, double h,
+                      const Motion * k, const double * a, int num)
+{
+   Motion out = m;
+   for (int i = 0; i < num; i++)
+   {
+      if (a[i] == 0.0)
+         continue;
+      out.x  += h * a[i] * k[i].x;
+      out.y  += h * a[i] * k[i].y;
+      out.vx += h * a[i] * k[i].vx;
+      out.vy += h * a[i] * k[i].vy;
+   }
+   return out;
+}
+
+/************************************************************************
+ * INTEGRATOR constructor
+ ************************************************************************/
+Integrator::Integrator(IntegratorType type, double tolerance) :
+   type(type), tolerance(tolerance)
+{
+   assert(tolerance > 0.0);
+   setType(type);
+}
+
+/************************************************************************
+ * SET TYPE
+ ************************************************************************/
+void Integrator::setType(IntegratorType type)
+{
+   assert(type != GAME_EULER);   // the Simulator does that one itself
+   this->type = type;
+}
+
+/************************************************************************
+ * STEP
+ ************************************************************************/
+void Integrator::step(Motion & m, double t, Acceleration accel, void * p)
+{
+   assert(accel != NULL);
+   double ax;
+   double ay;
+
+   switch (type)
+   {
+      case SEMI_IMPLICIT_EULER:
+         accel(m, ax, ay, p);
+         m.vx = phys.computeVelocity(m.vx, ax, t);
+         m.vy = phys.computeVelocity(m.vy, ay, t);
+         m.x = phys.computeDistance(m.x, m.vx, 0.0, t);
+         m.y = phys.computeDistance(m.y, m.vy, 0.0, t);
+         break;
+
+      case VELOCITY_VERLET:
+      {
+         // the position with the acceleration at the start, then the
+         // velocity with the average of the start and the end
+         accel(m, ax, ay, p);
+         m.x = phys.computeDistance(m.x, m.vx, ax, t);
+         m.y = phys.computeDistance(m.y, m.vy, ay, t);
+         double axEnd;
+         double ayEnd;
+         accel(m, axEnd, ayEnd, p);
+         m.vx = phys.computeVelocity(m.vx, 0.5 * (ax + axEnd), t);
+         m.vy = phys.computeVelocity(m.vy, 0.5 * (ay + ayEnd), t);
+         break;
+      }
+
+      case RK4:
+      {
+         static const double HALF[] = { 0.5 };
+         static const double FULL[] = { 1.0 };
+         static const double SUM[]  = { 1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0 };
+         Motion k[4];
+         k[0] = derivative(m, accel, p);
+         k[1] = derivative(combine(m, t, &k[0], HALF, 1), accel, p);
+         k[2] = derivative(combine(m, t, &k[1], HALF, 1), accel, p);
+         k[3] = derivative(combine(m, t, &k[2], FULL, 1), accel, p);
+         m = combine(m, t, k, SUM, 4);
+         break;
+      }
+
+      case RK45:
+      {
+         Motion next;
+         dormandPrince(m, next, t, accel, p);
+         m = next;
+         break;
+      }
+
+      default:
+         assert(false);
+   }
+}
+
+/************************************************************************
+ * DORMAND PRINCE
+ * Seven evaluations give a fifth order answer and a fourth order one.
+ * The answer kept is the fifth order one; the difference between them
+ * is the error
+ ************************************************************************/
+double Integrator::dormandPrince(const Motion & m, Motion & next, double h,
+                                 Acceleration accel, void * p) const
+{
+   static const double A2[] = { 1.0 / 5.0 };
+   static const double A3[] = { 3.0 / 40.0, 9.0 / 40.0 };
+   static const double A4[] = { 44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0 };
+   static const double A5[] = { 19372.0 / 6561.0, -25360.0 / 2187.0,
+                                64448.0 / 6561.0, -212.0 / 729.0 };
+   static const double A6[] = { 9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0,
+                                49.0 / 176.0, -5103.0 / 18656.0 };
+   static const double B5[] = { 35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0,
+                                -2187.0 / 6784.0, 11.0 / 84.0 };
+   static const double E[]  = { 71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0,
+                                -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0 };
+
+   Motion k[7];
+   k[0] = derivative(m, accel, p);
+   k[1] = derivative(combine(m, h, k, A2, 1), accel, p);
+   k[2] = derivative(combine(m, h, k, A3, 2), accel, p);
+   k[3] = derivative(combine(m, h, k, A4, 3), accel, p);
+   k[4] = derivative(combine(m, h, k, A5, 4), accel, p);
+   k[5] = derivative(combine(m, h, k, A6, 5), accel, p);
+   next = combine(m, h, k, B5, 6);
+   k[6] = derivative(next, accel, p);
+
+   // the error of each value, scaled by the size of the value
+   Motion zero = { 0.0, 0.0, 0.0, 0.0 };
+   Motion error = combine(zero, h, k, E, 7);
+   const double errors[] = { error.x, error.y, error.vx, error.vy };
+   const double before[] = { m.x, m.y, m.vx, m.vy };
+   const double after[]  = { next.x, next.y, next.vx, next.vy };
+   double worst = 0.0;
+   for (int i = 0; i < 4; i++)
+   {
+      double scale = tolerance * fmax(1.0, fmax(fabs(before[i]), fabs(after[i])));
+      worst = fmax(worst, fabs(errors[i]) / scale);
+   }
+   return worst;
+}
+
+/************************************************************************
+ * ADAPT
+ * Try a step, and if the error is too big try again with a smaller one.
+ * Either way the error says what the next step should be
+ ************************************************************************/
+double Integrator::adapt(Motion & m, double tMax, double & h,
+                         Acceleration accel, void * p)
+{
+   assert(accel != NULL);
+   assert(tMax > 0.0);
+   if (h <= 0.0 || h > tMax)
+      h = tMax;
+
+   for (;;)
+   {
+      Motion next;
+      double error = dormandPrince(m, next, h, accel, p);
+      double growth = error == 0.0 ? MAX_GROWTH :
+                      fmin(MAX_GROWTH, fmax(MIN_GROWTH, SAFETY * pow(error, -0.2)));
+
+      // good enough, or so small that going on would not help
+      if (error <= 1.0 || h <= tMax * 1e-9)
+      {
+         m = next;
+         double taken = h;
+         h *= growth;
+         return taken;
+      }
+      h *= growth;
+   }
+}
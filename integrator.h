@@ -0,0 +1,91 @@
+/***********************************************************************
+ * Header File:
+ *    Integrator : Move a body through time under an acceleration
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Several ways to solve x'' = a(x, v) over a step, built on the
+ *    kinematics in physics:
+ *
+ *       SEMI_IMPLICIT_EULER  the velocity first, then the position with
+ *                            the new velocity. First order, symplectic
+ *       VELOCITY_VERLET      second order, symplectic
+ *       RK4                  the classic fourth order Runge-Kutta
+ *       RK45                 Dormand-Prince: fifth order with a fourth
+ *                            order estimate beside it. The difference
+ *                            says how big a step can be and still stay
+ *                            within the tolerance
+ *
+ *    With a constant acceleration Verlet and RK4 are exact for any step
+ *    size, so a batch run can use far fewer steps than the game does.
+ ************************************************************************/
+
+#pragma once
+
+#include "physics.h"  // for the kinematics equations
+
+/*********************************************
+ * INTEGRATOR TYPE
+ * GAME_EULER is how the game has always moved
+ * the lander. It is left to the Simulator so
+ * recorded games fly the same as they always did
+ *********************************************/
+enum IntegratorType
+{
+   GAME_EULER,
+   SEMI_IMPLICIT_EULER,
+   VELOCITY_VERLET,
+   RK4,
+   RK45
+};
+
+/*********************************************
+ * MOTION
+ * Where a body is and how fast it is going
+ *********************************************/
+struct Motion
+{
+   double x;
+   double y;
+   double vx;
+   double vy;
+};
+
+// the acceleration of a body at a given point in its motion
+typedef void (*Acceleration)(const Motion & m, double & ax, double & ay, void * p);
+
+/***********************************************************
+ * INTEGRATOR
+ * Advance a Motion by a step
+ ***********************************************************/
+class Integrator
+{
+public:
+   // tolerance is the largest error RK45 allows in a step, relative to
+   // the size of the values (or absolute, for values smaller than one)
+   Integrator(IntegratorType type = SEMI_IMPLICIT_EULER, double tolerance = 1e-6);
+
+   IntegratorType getType() const { return type; }
+   void setType(IntegratorType type);
+   double getTolerance() const { return tolerance; }
+
+   // advance by exactly t. RK45 takes a single step of t without
+   // checking the error
+   void step(Motion & m, double t, Acceleration accel, void * p);
+
+   // RK45: take a step no longer than tMax, starting with a try of h
+   // and shrinking it until the error is small enough. Returns the time
+   // advanced, and sets h to the step to try next
+   double adapt(Motion & m, double tMax, double & h,
+                Acceleration accel, void * p);
+
+private:
+   // one Dormand-Prince step from m into next. Returns the error
+   // relative to the tolerance, so anything up to one is good enough
+   double dormandPrince(const Motion & m, Motion & next, double h,
+                        Acceleration accel, void * p) const;
+
+   physics phys;              // the kinematics equations
+   IntegratorType type;
+   double tolerance;
+};
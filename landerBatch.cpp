@@ -0,0 +1,608 @@
+/***********************************************************************
+ * Source File:
+ *    Lander Batch : Many landers stepped at once
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    The same step as the Simulator, but for a whole batch of landers
+ *    stored as contiguous arrays (structure-of-arrays). The kinematics
+ *    are done with AVX2 or NEON when the CPU has them. The scalar
+ *    fallback performs exactly the same floating point operations in
+ *    the same order, so both give bit-identical results.
+ ************************************************************************/
+
+#include "landerBatch.h"  // for the LanderBatch class definition
+#include <cassert>
+#include <cmath>          // for sqrt() and nearbyint()
+#include <cstring>        // for memcpy()
+#include <cstdint>        // for int64_t
+
+// Bit-identical results need every multiply and add rounded on its own.
+// Do not let the compiler fuse them into FMA instructions.
+#if defined(_MSC_VER)
+#pragma fp_contract (off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+// pick the vector instruction set. LANDER_BATCH_SCALAR turns it off
+#if !defined(LANDER_BATCH_SCALAR)
+#if defined(__x86_64__) || defined(_M_X64)
+#define LANDER_BATCH_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>       // for __cpuidex()
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define LANDER_BATCH_NEON
+#include <arm_neon.h>
+#endif
+#endif // !LANDER_BATCH_SCALAR
+
+/******************************************************************
+ * SINE AND COSINE
+ * Reduce to [-pi/4, pi/4] by quadrant with a three-part pi/2, then
+ * use the Cephes polynomials. Every vector lane does the same steps.
+ ****************************************************************/
+const double TWO_OVER_PI = 6.36619772367581382433E-1;
+const double PIO2_1      = 1.57079625129699707031E0;
+const double PIO2_2      = 7.54978941586159635336E-8;
+const double PIO2_3      = 5.39030285815811905290E-15;
+const double ROUND_MAGIC = 6755399441055744.0;  // 1.5 * 2^52
+
+const double S0 =  1.58962301576546568060E-10;
+const double S1 = -2.50507477628578072866E-8;
+const double S2 =  2.75573136213857245213E-6;
+const double S3 = -1.98412698295895385996E-4;
+const double S4 =  8.33333333332211858878E-3;
+const double S5 = -1.66666666666666307295E-1;
+
+const double C0 = -1.13585365213876817300E-11;
+const double C1 =  2.08757008419747316778E-9;
+const double C2 = -2.75573141792967388112E-7;
+const double C3 =  2.48015872888517045348E-5;
+const double C4 = -1.38888888888730564116E-3;
+const double C5 =  4.16666666666665929218E-2;
+
+/******************************************************************
+ * BATCH SIN COS
+ * The scalar version of the kernel's sine and cosine
+ ****************************************************************/
+void batchSinCos(double angle, double & s, double & c)
+{
+   // which quadrant are we in?
+   double j = std::nearbyint(angle * TWO_OVER_PI);
+   double magic = j + ROUND_MAGIC;
+   int64_t bits;
+   memcpy(&bits, &magic, sizeof(bits));
+   int quadrant = (int)(bits & 3);
+
+   // the remainder
+   double r = ((angle - j * PIO2_1) - j * PIO2_2) - j * PIO2_3;
+   double z = r * r;
+
+   double ps = ((((S0 * z + S1) * z + S2) * z + S3) * z + S4) * z + S5;
+   double pc = ((((C0 * z + C1) * z + C2) * z + C3) * z + C4) * z + C5;
+   double sinR = r + r * (z * ps);
+   double cosR = (1.0 - 0.5 * z) + (z * z) * pc;
+
+   // put it back in the right quadrant
+   switch (quadrant)
+   {
+      case 0:  s =  sinR; c =  cosR; break;
+      case 1:  s =  cosR; c = -sinR; break;
+      case 2:  s = -sinR; c = -cosR; break;
+      default: s = -cosR; c =  sinR; break;
+   }
+}
+
+/******************************************************************
+ * SCALAR KERNELS
+ ****************************************************************/
+static void velocityScalar(double * v, const double * a, double t,
+                           const unsigned char * status, int begin, int n)
+{
+   for (int i = begin; i < n; i++)
+      if (!status || status[i] == FLYING)
+         v[i] = v[i] + (a[i] * t);
+}
+
+static void distanceScalar(double * s, const double * v, double sign,
+                           const double * a, double t,
+                           const unsigned char * status, int begin, int n)
+{
+   double tt = t * t;
+   for (int i = begin; i < n; i++)
+      if (!status || status[i] == FLYING)
+         s[i] = s[i] + ((sign * v[i]) * t) + (0.5 * a[i]) * tt;
+}
+
+static void componentsScalar(const double * angle, const double * total,
+                             double gravity,
+                             double * horizontal, double * vertical,
+                             int begin, int n)
+{
+   for (int i = begin; i < n; i++)
+   {
+      double s;
+      double c;
+      batchSinCos(angle[i], s, c);
+      horizontal[i] = total[i] * s;
+      vertical[i] = total[i] * c + gravity;
+   }
+}
+
+#ifdef LANDER_BATCH_AVX2
+/******************************************************************
+ * AVX2 KERNELS
+ * Four landers at a time
+ ****************************************************************/
+
+// the lanes where the lander is still flying
+TARGET_AVX2 static inline __m256d flyingMask(const unsigned char * status)
+{
+   int bytes;
+   memcpy(&bytes, status, sizeof(bytes));
+   __m256i st = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+   return _mm256_castsi256_pd(_mm256_cmpeq_epi64(st, _mm256_setzero_si256()));
+}
+
+TARGET_AVX2 static int velocityAvx2(double * v, const double * a, double t,
+                                    const unsigned char * status, int n)
+{
+   __m256d vt = _mm256_set1_pd(t);
+   int i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      __m256d vOld = _mm256_loadu_pd(v + i);
+      __m256d vNew = _mm256_add_pd(vOld, _mm256_mul_pd(_mm256_loadu_pd(a + i), vt));
+      if (status)
+         vNew = _mm256_blendv_pd(vOld, vNew, flyingMask(status + i));
+      _mm256_storeu_pd(v + i, vNew);
+   }
+   return i;
+}
+
+TARGET_AVX2 static int distanceAvx2(double * s, const double * v, double sign,
+                                    const double * a, double t,
+                                    const unsigned char * status, int n)
+{
+   __m256d vt    = _mm256_set1_pd(t);
+   __m256d vtt   = _mm256_set1_pd(t * t);
+   __m256d vsign = _mm256_set1_pd(sign);
+   __m256d vhalf = _mm256_set1_pd(0.5);
+   int i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      __m256d sOld = _mm256_loadu_pd(s + i);
+      __m256d vt1  = _mm256_mul_pd(_mm256_mul_pd(vsign, _mm256_loadu_pd(v + i)), vt);
+      __m256d at2  = _mm256_mul_pd(_mm256_mul_pd(vhalf, _mm256_loadu_pd(a + i)), vtt);
+      __m256d sNew = _mm256_add_pd(_mm256_add_pd(sOld, vt1), at2);
+      if (status)
+         sNew = _mm256_blendv_pd(sOld, sNew, flyingMask(status + i));
+      _mm256_storeu_pd(s + i, sNew);
+   }
+   return i;
+}
+
+// evaluate a fifth order polynomial the same way as the scalar code
+TARGET_AVX2 static inline __m256d polynomial(__m256d z, double p0, double p1,
+                                             double p2, double p3,
+                                             double p4, double p5)
+{
+   __m256d p = _mm256_set1_pd(p0);
+   p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(p1));
+   p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(p2));
+   p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(p3));
+   p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(p4));
+   return _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(p5));
+}
+
+TARGET_AVX2 static int componentsAvx2(const double * angle, const double * total,
+                                      double gravity,
+                                      double * horizontal, double * vertical,
+                                      int n)
+{
+   __m256d vgravity = _mm256_set1_pd(gravity);
+   __m256d signBit  = _mm256_set1_pd(-0.0);
+   __m256i one      = _mm256_set1_epi64x(1);
+   __m256i two      = _mm256_set1_epi64x(2);
+   int i = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      __m256d a = _mm256_loadu_pd(angle + i);
+
+      // which quadrant are we in?
+      __m256d j = _mm256_round_pd(_mm256_mul_pd(a, _mm256_set1_pd(TWO_OVER_PI)),
+                                  _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+      __m256i q = _mm256_castpd_si256(_mm256_add_pd(j, _mm256_set1_pd(ROUND_MAGIC)));
+
+      // the remainder
+      __m256d r = _mm256_sub_pd(a, _mm256_mul_pd(j, _mm256_set1_pd(PIO2_1)));
+      r = _mm256_sub_pd(r, _mm256_mul_pd(j, _mm256_set1_pd(PIO2_2)));
+      r = _mm256_sub_pd(r, _mm256_mul_pd(j, _mm256_set1_pd(PIO2_3)));
+      __m256d z = _mm256_mul_pd(r, r);
+
+      __m256d ps = polynomial(z, S0, S1, S2, S3, S4, S5);
+      __m256d pc = polynomial(z, C0, C1, C2, C3, C4, C5);
+      __m256d sinR = _mm256_add_pd(r, _mm256_mul_pd(r, _mm256_mul_pd(z, ps)));
+      __m256d cosR = _mm256_add_pd(
+         _mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), z)),
+         _mm256_mul_pd(_mm256_mul_pd(z, z), pc));
+
+      // odd quadrants swap sine and cosine
+      __m256d swap = _mm256_castsi256_pd(
+         _mm256_cmpeq_epi64(_mm256_and_si256(q, one), one));
+      __m256d s = _mm256_blendv_pd(sinR, cosR, swap);
+      __m256d c = _mm256_blendv_pd(cosR, sinR, swap);
+
+      // quadrants 2 and 3 negate the sine, quadrants 1 and 2 the cosine
+      __m256i qs = _mm256_and_si256(q, two);
+      __m256i qc = _mm256_and_si256(_mm256_add_epi64(q, one), two);
+      __m256d negS = _mm256_and_pd(signBit,
+         _mm256_castsi256_pd(_mm256_cmpeq_epi64(qs, two)));
+      __m256d negC = _mm256_and_pd(signBit,
+         _mm256_castsi256_pd(_mm256_cmpeq_epi64(qc, two)));
+      s = _mm256_xor_pd(s, negS);
+      c = _mm256_xor_pd(c, negC);
+
+      __m256d tot = _mm256_loadu_pd(total + i);
+      _mm256_storeu_pd(horizontal + i, _mm256_mul_pd(tot, s));
+      _mm256_storeu_pd(vertical + i,
+                       _mm256_add_pd(_mm256_mul_pd(tot, c), vgravity));
+   }
+   return i;
+}
+
+/******************************************************************
+ * HAS AVX2
+ * Ask the CPU once whether it can run the AVX2 kernels
+ ****************************************************************/
+static bool hasAvx2()
+{
+#ifdef _MSC_VER
+   static const bool avx2 = []()
+   {
+      int info[4];
+      __cpuidex(info, 7, 0);
+      return (info[1] & (1 << 5)) != 0;
+   }();
+#else
+   static const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+   return avx2;
+}
+#endif // LANDER_BATCH_AVX2
+
+#ifdef LANDER_BATCH_NEON
+/******************************************************************
+ * NEON KERNELS
+ * Two landers at a time
+ ****************************************************************/
+
+// the lanes where the lander is still flying
+static inline uint64x2_t flyingMask(const unsigned char * status)
+{
+   uint64_t st[2] = { status[0], status[1] };
+   return vceqzq_u64(vld1q_u64(st));
+}
+
+static int velocityNeon(double * v, const double * a, double t,
+                        const unsigned char * status, int n)
+{
+   float64x2_t vt = vdupq_n_f64(t);
+   int i = 0;
+   for (; i + 2 <= n; i += 2)
+   {
+      float64x2_t vOld = vld1q_f64(v + i);
+      float64x2_t vNew = vaddq_f64(vOld, vmulq_f64(vld1q_f64(a + i), vt));
+      if (status)
+         vNew = vbslq_f64(flyingMask(status + i), vNew, vOld);
+      vst1q_f64(v + i, vNew);
+   }
+   return i;
+}
+
+static int distanceNeon(double * s, const double * v, double sign,
+                        const double * a, double t,
+                        const unsigned char * status, int n)
+{
+   float64x2_t vt    = vdupq_n_f64(t);
+   float64x2_t vtt   = vdupq_n_f64(t * t);
+   float64x2_t vsign = vdupq_n_f64(sign);
+   float64x2_t vhalf = vdupq_n_f64(0.5);
+   int i = 0;
+   for (; i + 2 <= n; i += 2)
+   {
+      float64x2_t sOld = vld1q_f64(s + i);
+      float64x2_t vt1  = vmulq_f64(vmulq_f64(vsign, vld1q_f64(v + i)), vt);
+      float64x2_t at2  = vmulq_f64(vmulq_f64(vhalf, vld1q_f64(a + i)), vtt);
+      float64x2_t sNew = vaddq_f64(vaddq_f64(sOld, vt1), at2);
+      if (status)
+         sNew = vbslq_f64(flyingMask(status + i), sNew, sOld);
+      vst1q_f64(s + i, sNew);
+   }
+   return i;
+}
+
+// evaluate a fifth order polynomial the same way as the scalar code
+static inline float64x2_t polynomial(float64x2_t z, double p0, double p1,
+                                     double p2, double p3,
+                                     double p4, double p5)
+{
+   float64x2_t p = vdupq_n_f64(p0);
+   p = vaddq_f64(vmulq_f64(p, z), vdupq_n_f64(p1));
+   p = vaddq_f64(vmulq_f64(p, z), vdupq_n_f64(p2));
+   p = vaddq_f64(vmulq_f64(p, z), vdupq_n_f64(p3));
+   p = vaddq_f64(vmulq_f64(p, z), vdupq_n_f64(p4));
+   return vaddq_f64(vmulq_f64(p, z), vdupq_n_f64(p5));
+}
+
+static int componentsNeon(const double * angle, const double * total,
+                          double gravity,
+                          double * horizontal, double * vertical, int n)
+{
+   float64x2_t vgravity = vdupq_n_f64(gravity);
+   uint64x2_t  signBit  = vdupq_n_u64(0x8000000000000000ULL);
+   uint64x2_t  one      = vdupq_n_u64(1);
+   uint64x2_t  two      = vdupq_n_u64(2);
+   int i = 0;
+   for (; i + 2 <= n; i += 2)
+   {
+      float64x2_t a = vld1q_f64(angle + i);
+
+      // which quadrant are we in?
+      float64x2_t j = vrndnq_f64(vmulq_f64(a, vdupq_n_f64(TWO_OVER_PI)));
+      uint64x2_t q = vreinterpretq_u64_f64(vaddq_f64(j, vdupq_n_f64(ROUND_MAGIC)));
+
+      // the remainder
+      float64x2_t r = vsubq_f64(a, vmulq_f64(j, vdupq_n_f64(PIO2_1)));
+      r = vsubq_f64(r, vmulq_f64(j, vdupq_n_f64(PIO2_2)));
+      r = vsubq_f64(r, vmulq_f64(j, vdupq_n_f64(PIO2_3)));
+      float64x2_t z = vmulq_f64(r, r);
+
+      float64x2_t ps = polynomial(z, S0, S1, S2, S3, S4, S5);
+      float64x2_t pc = polynomial(z, C0, C1, C2, C3, C4, C5);
+      float64x2_t sinR = vaddq_f64(r, vmulq_f64(r, vmulq_f64(z, ps)));
+      float64x2_t cosR = vaddq_f64(
+         vsubq_f64(vdupq_n_f64(1.0), vmulq_f64(vdupq_n_f64(0.5), z)),
+         vmulq_f64(vmulq_f64(z, z), pc));
+
+      // odd quadrants swap sine and cosine
+      uint64x2_t swap = vceqq_u64(vandq_u64(q, one), one);
+      float64x2_t s = vbslq_f64(swap, cosR, sinR);
+      float64x2_t c = vbslq_f64(swap, sinR, cosR);
+
+      // quadrants 2 and 3 negate the sine, quadrants 1 and 2 the cosine
+      uint64x2_t negS = vandq_u64(signBit, vceqq_u64(vandq_u64(q, two), two));
+      uint64x2_t negC = vandq_u64(signBit,
+                                  vceqq_u64(vandq_u64(vaddq_u64(q, one), two), two));
+      s = vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(s), negS));
+      c = vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(c), negC));
+
+      float64x2_t tot = vld1q_f64(total + i);
+      vst1q_f64(horizontal + i, vmulq_f64(tot, s));
+      vst1q_f64(vertical + i, vaddq_f64(vmulq_f64(tot, c), vgravity));
+   }
+   return i;
+}
+#endif // LANDER_BATCH_NEON
+
+/******************************************************************
+ * BATCH VELOCITY
+ ****************************************************************/
+void batchVelocity(double * v, const double * a, double t,
+                   const unsigned char * status, int n, bool vectorize)
+{
+   int i = 0;
+#if defined(LANDER_BATCH_AVX2)
+   if (vectorize && hasAvx2())
+      i = velocityAvx2(v, a, t, status, n);
+#elif defined(LANDER_BATCH_NEON)
+   if (vectorize)
+      i = velocityNeon(v, a, t, status, n);
+#endif
+   velocityScalar(v, a, t, status, i, n);
+}
+
+/******************************************************************
+ * BATCH DISTANCE
+ ****************************************************************/
+void batchDistance(double * s, const double * v, double sign,
+                   const double * a, double t,
+                   const unsigned char * status, int n, bool vectorize)
+{
+   int i = 0;
+#if defined(LANDER_BATCH_AVX2)
+   if (vectorize && hasAvx2())
+      i = distanceAvx2(s, v, sign, a, t, status, n);
+#elif defined(LANDER_BATCH_NEON)
+   if (vectorize)
+      i = distanceNeon(s, v, sign, a, t, status, n);
+#endif
+   distanceScalar(s, v, sign, a, t, status, i, n);
+}
+
+/******************************************************************
+ * BATCH COMPONENTS
+ ****************************************************************/
+void batchComponents(const double * angle, const double * total,
+                     double gravity,
+                     double * horizontal, double * vertical, int n,
+                     bool vectorize)
+{
+   int i = 0;
+#if defined(LANDER_BATCH_AVX2)
+   if (vectorize && hasAvx2())
+      i = componentsAvx2(angle, total, gravity, horizontal, vertical, n);
+#elif defined(LANDER_BATCH_NEON)
+   if (vectorize)
+      i = componentsNeon(angle, total, gravity, horizontal, vertical, n);
+#endif
+   componentsScalar(angle, total, gravity, horizontal, vertical, i, n);
+}
+
+/******************************************************************
+ * BATCH INSTRUCTION SET
+ ****************************************************************/
+const char * batchInstructionSet()
+{
+#if defined(LANDER_BATCH_AVX2)
+   return hasAvx2() ? "avx2" : "scalar";
+#elif defined(LANDER_BATCH_NEON)
+   return "neon";
+#else
+   return "scalar";
+#endif
+}
+
+/************************************************************************
+ * LANDER BATCH : RESIZE
+ * New landers start out crashed so they do not move until set()
+ ************************************************************************/
+void LanderBatch::resize(int n)
+{
+   assert(n >= 0);
+   this->n = n;
+   x.resize(n, 0.0);
+   y.resize(n, 0.0);
+   dx.resize(n, 0.0);
+   dy.resize(n, 0.0);
+   angle.resize(n, 0.0);
+   thrust.resize(n, 0.0);
+   fuel.resize(n, 0);
+   status.resize(n, (unsigned char)CRASHED);
+   ddx.resize(n, 0.0);
+   ddy.resize(n, 0.0);
+}
+
+/************************************************************************
+ * LANDER BATCH : SET
+ ************************************************************************/
+void LanderBatch::set(int i, const LanderState & state)
+{
+   assert(0 <= i && i < n);
+   x[i]      = state.x;
+   y[i]      = state.y;
+   dx[i]     = state.dx;
+   dy[i]     = state.dy;
+   angle[i]  = state.angle;
+   thrust[i] = state.thrust;
+   fuel[i]   = state.fuel;
+   status[i] = (unsigned char)state.status;
+}
+
+/************************************************************************
+ * LANDER BATCH : GET
+ ************************************************************************/
+LanderState LanderBatch::get(int i) const
+{
+   assert(0 <= i && i < n);
+   LanderState state;
+   state.x      = x[i];
+   state.y      = y[i];
+   state.dx     = dx[i];
+   state.dy     = dy[i];
+   state.angle  = angle[i];
+   state.thrust = thrust[i];
+   state.fuel   = fuel[i];
+   state.status = (LanderStatus)status[i];
+   return state;
+}
+
+/************************************************************************
+ * LANDER BATCH : STEP
+ ************************************************************************/
+void LanderBatch::step(const Ground & ground, const unsigned char * controls,
+                       double tTime)
+{
+   step(ground, controls, tTime, true /*vectorize*/);
+}
+
+void LanderBatch::stepScalar(const Ground & ground, const unsigned char * controls,
+                             double tTime)
+{
+   step(ground, controls, tTime, false /*vectorize*/);
+}
+
+/************************************************************************
+ * LANDER BATCH : STEP
+ * The same sequence as Simulator::step, one pass per stage. Only the
+ * sine and cosine differ, so the results can differ in the last bits
+ ************************************************************************/
+void LanderBatch::step(const Ground & ground, const unsigned char * controls,
+                       double tTime, bool vectorize)
+{
+   assert(controls != NULL || n == 0);
+   if (n == 0)
+      return;
+
+   // the acceleration comes from the engine as it was during the last step
+   batchComponents(&angle[0], &thrust[0], GRAVITY, &ddx[0], &ddy[0], n,
+                   vectorize);
+
+   // respond to the controls
+   const double accelerationThrust = THRUST / WEIGHT;
+   for (int i = 0; i < n; i++)
+   {
+      if (status[i] != FLYING)
+         continue;
+
+      if (fuel[i] > 0)
+      {
+         if (controls[i] & CONTROL_RIGHT)
+         {
+            fuel[i] -= FUEL_ROTATE;
+            angle[i] -= ROTATE;
+         }
+
+         if (controls[i] & CONTROL_LEFT)
+         {
+            fuel[i] -= FUEL_ROTATE;
+            angle[i] += ROTATE;
+         }
+
+         if (controls[i] & CONTROL_UP)
+         {
+            fuel[i] -= FUEL_THRUST;
+            if (fuel[i] < 0)
+               fuel[i] = 0;
+            thrust[i] = accelerationThrust;
+         }
+         else
+            thrust[i] = 0.0;
+      }
+      else
+         thrust[i] = 0.0;
+   }
+
+   // compute the new velocity, then use it to update the position
+   batchVelocity(&dx[0], &ddx[0], tTime, &status[0], n, vectorize);
+   batchVelocity(&dy[0], &ddy[0], tTime, &status[0], n, vectorize);
+   batchDistance(&x[0], &dx[0], -1.0, &ddx[0], tTime, &status[0], n, vectorize);
+   batchDistance(&y[0], &dy[0],  1.0, &ddy[0], tTime, &status[0], n, vectorize);
+
+   // did we hit anything?
+   for (int i = 0; i < n; i++)
+   {
+      if (status[i] != FLYING)
+         continue;
+
+      Point ptLM(x[i], y[i]);
+      if (ground.hitGround(ptLM, LANDER_WIDTH))
+         status[i] = CRASHED;
+
+      if (ground.onPlatform(ptLM, LANDER_WIDTH))
+      {
+         if (dy[i] <= 4 && dx[i] <= 2)
+            status[i] = LANDED;
+         else if (sqrt(dx[i] * dx[i] + dy[i] * dy[i]) > 4)
+            status[i] = CRASHED;
+      }
+   }
+}
@@ -0,0 +1,103 @@
+/***********************************************************************
+ * Header File:
+ *    Lander Batch : Many landers stepped at once
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    The Simulator's step, but for a whole batch of landers stored as
+ *    contiguous arrays (structure-of-arrays). The kinematics are done
+ *    with AVX2 or NEON when the CPU has them. The scalar fallback
+ *    performs exactly the same floating point operations in the same
+ *    order, so both give bit-identical results.
+ *
+ *    The rules are the Simulator's but the bits are not: the batch
+ *    works out sine and cosine with its own polynomials rather than
+ *    std::sin() and std::cos(), so a lander can drift a few ulps from
+ *    where Simulator::step() would put it.
+ ************************************************************************/
+
+#pragma once
+
+#include <vector>        // for the arrays of landers
+#include "simulator.h"   // for LanderState and the lander constants
+
+// the controls for one lander, packed into a byte
+const unsigned char CONTROL_UP    = 0x01;
+const unsigned char CONTROL_LEFT  = 0x02;
+const unsigned char CONTROL_RIGHT = 0x04;
+
+/***********************************************************
+ * LANDER BATCH
+ * A structure-of-arrays store of landers
+ ***********************************************************/
+class LanderBatch
+{
+public:
+   LanderBatch() : n(0) {}
+   LanderBatch(int n) : n(0) { resize(n); }
+
+   // how many landers are in the batch
+   void resize(int n);
+   int  size() const { return n; }
+
+   // move a single lander in and out of the batch
+   void set(int i, const LanderState & state);
+   LanderState get(int i) const;
+
+   // advance every flying lander one step. The controls array has
+   // one byte per lander made from the CONTROL_ flags
+   void step(const Ground & ground, const unsigned char * controls,
+             double tTime = 0.1);
+
+   // the same, with the vector kernels turned off
+   void stepScalar(const Ground & ground, const unsigned char * controls,
+                   double tTime = 0.1);
+
+   // one element per lander
+   std::vector<double> x;              // horizontal position
+   std::vector<double> y;              // vertical position
+   std::vector<double> dx;             // horizontal velocity
+   std::vector<double> dy;             // vertical velocity
+   std::vector<double> angle;          // radians, 0 is up
+   std::vector<double> thrust;         // engine acceleration last step
+   std::vector<int>    fuel;           // fuel remaining
+   std::vector<unsigned char> status;  // a LanderStatus
+
+private:
+   void step(const Ground & ground, const unsigned char * controls,
+             double tTime, bool vectorize);
+
+   int n;                              // number of landers
+   std::vector<double> ddx;            // scratch: horizontal acceleration
+   std::vector<double> ddy;            // scratch: vertical acceleration
+};
+
+/******************************************************************
+ * BATCH KERNELS
+ * Array versions of the physics compute functions. The status
+ * array is optional: when given, only FLYING elements are written.
+ * Pass vectorize = false to force the scalar fallback.
+ ****************************************************************/
+
+// v = v + a t
+void batchVelocity(double * v, const double * a, double t,
+                   const unsigned char * status, int n,
+                   bool vectorize = true);
+
+// s = s + (sign v) t + 1/2 a t^2
+void batchDistance(double * s, const double * v, double sign,
+                   const double * a, double t,
+                   const unsigned char * status, int n,
+                   bool vectorize = true);
+
+// horizontal = total sin(angle), vertical = total cos(angle) + gravity
+void batchComponents(const double * angle, const double * total,
+                     double gravity,
+                     double * horizontal, double * vertical, int n,
+                     bool vectorize = true);
+
+// sine and cosine as computed by the kernels above
+void batchSinCos(double angle, double & s, double & c);
+
+// which instruction set the kernels are using: "avx2", "neon", "scalar"
+const char * batchInstructionSet();
@@ -0,0 +1,99 @@
+/***********************************************************************
+ * Source File:
+ *    Lander Geometry : The shape of the LM, for drawing and for hitting
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Turn the outline of the lander and put it where the lander is.
+ ************************************************************************/
+
+#include "landerGeometry.h"  // for the LanderShape class definition
+#include <cmath>             // for sin(), cos() and sqrt()
+#include <cassert>
+#include <algorithm>         // for std::min() and std::max()
+
+#define COUNT(array) ((int)(sizeof(array) / sizeof((array)[0])))
+
+/************************************************************************
+ * PLACE
+ ************************************************************************/
+void LanderShape::place(const Point & pt, double angle)
+{
+   double cosA = cos(angle);
+   double sinA = sin(angle);
+
+   numSegments = 0;
+   addOutline(LANDER_LEGS, COUNT(LANDER_LEGS), false /*closed*/, pt, cosA, sinA);
+   addOutline(LANDER_ENGINE_UNIT, COUNT(LANDER_ENGINE_UNIT), true, pt, cosA, sinA);
+   addOutline(LANDER_ENGINE, COUNT(LANDER_ENGINE), true, pt, cosA, sinA);
+   addOutline(LANDER_THRUSTERS, COUNT(LANDER_THRUSTERS), true, pt, cosA, sinA);
+
+   // the edge of the fan, which already comes back to where it started
+   addOutline(LANDER_HABITAT + 1, COUNT(LANDER_HABITAT) - 1, false, pt, cosA, sinA);
+
+   const LanderVertex & leftFoot = LANDER_LEGS[0];
+   const LanderVertex & rightFoot = LANDER_LEGS[COUNT(LANDER_LEGS) - 1];
+   feet[0] = rotate(pt, leftFoot.x, leftFoot.y, cosA, sinA);
+   feet[1] = rotate(pt, rightFoot.x, rightFoot.y, cosA, sinA);
+
+   left = right = starts[0].getX();
+   bottom = top = starts[0].getY();
+   for (int i = 0; i < numSegments; i++)
+   {
+      left   = std::min(left,   std::min(starts[i].getX(), ends[i].getX()));
+      right  = std::max(right,  std::max(starts[i].getX(), ends[i].getX()));
+      bottom = std::min(bottom, std::min(starts[i].getY(), ends[i].getY()));
+      top    = std::max(top,    std::max(starts[i].getY(), ends[i].getY()));
+   }
+}
+
+/************************************************************************
+ * ADD OUTLINE
+ ************************************************************************/
+void LanderShape::addOutline(const LanderVertex * vertices, int num, bool closed,
+                             const Point & pt, double cosA, double sinA)
+{
+   Point first = rotate(pt, vertices[0].x, vertices[0].y, cosA, sinA);
+   Point previous = first;
+   for (int i = 1; i <= num; i++)
+   {
+      if (i == num && !closed)
+         break;
+      Point next = i == num ? first : rotate(pt, vertices[i].x, vertices[i].y, cosA, sinA);
+      assert(numSegments < MAX_SEGMENTS);
+      starts[numSegments] = previous;
+      ends[numSegments] = next;
+      numSegments++;
+      previous = next;
+   }
+}
+
+/************************************************************************
+ * FARTHEST
+ * The farthest of some vertices from the pivot
+ ************************************************************************/
+static double farthest(const LanderVertex * vertices, int num, double radius)
+{
+   for (int i = 0; i < num; i++)
+   {
+      double dy = vertices[i].y - LANDER_PIVOT_Y;
+      radius = std::max(radius, sqrt(vertices[i].x * vertices[i].x + dy * dy));
+   }
+   return radius;
+}
+
+/************************************************************************
+ * GET RADIUS
+ * The farthest vertex of the outline from the pivot. Turning does not
+ * change it
+ ************************************************************************/
+double LanderShape::getRadius()
+{
+   static const double radius =
+      farthest(LANDER_LEGS, COUNT(LANDER_LEGS),
+      farthest(LANDER_ENGINE_UNIT, COUNT(LANDER_ENGINE_UNIT),
+      farthest(LANDER_ENGINE, COUNT(LANDER_ENGINE),
+      farthest(LANDER_THRUSTERS, COUNT(LANDER_THRUSTERS),
+      farthest(LANDER_HABITAT, COUNT(LANDER_HABITAT), 0.0)))));
+   return radius;
+}
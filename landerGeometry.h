@@ -0,0 +1,112 @@
+/***********************************************************************
+ * Header File:
+ *    Lander Geometry : The shape of the LM, for drawing and for hitting
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    The outline of the lander as drawLander() draws it, in pixels from
+ *    the point between the feet. The same vertices are drawn and are
+ *    used to test for touching the ground, so what the player sees is
+ *    what hits. A LanderShape is the outline turned to the lander's
+ *    angle and moved to where it is, as a list of line segments with a
+ *    box around them.
+ ************************************************************************/
+
+#pragma once
+
+#include "point.h"   // for Point
+
+/*********************************************
+ * LANDER VERTEX
+ * A corner of the lander, relative to the
+ * point between the feet
+ *********************************************/
+struct LanderVertex
+{
+   int x;
+   int y;
+};
+
+// the lander turns about this point above its feet
+const double LANDER_PIVOT_Y = 8.0;
+
+// the landing legs, as one line strip. The first and last are the feet
+const LanderVertex LANDER_LEGS[] =
+{
+   {-10,0}, {-6,0}, {-9,1}, {-9,8}, {-5,3}, {-9,8}, {-5,6},
+   {5,6},   {9,8},  {5,3},  {9,8},  {9,1},  {6,0},  {10,0}
+};
+
+// the gold engine unit, the engine, and the horizontal thrusters: quads
+const LanderVertex LANDER_ENGINE_UNIT[] = { {-5,3}, {-5,7}, {5,7}, {5,3} };
+const LanderVertex LANDER_ENGINE[]      = { {-4,1}, {-2,3}, {2,3}, {4,1} };
+const LanderVertex LANDER_THRUSTERS[]   = { {-8,12}, {-8,11}, {8,11}, {9,12} };
+
+// the main habitat, as a triangle fan about its first vertex
+const LanderVertex LANDER_HABITAT[] =
+{
+   {0,10},
+   {3,7}, {-3, 7}, {-5,9}, {-5,12}, {-3, 16},
+   {3,16}, {5,12}, {5,9}, {3,7}
+};
+
+// the window is a triangle and the storage units a quad
+const LanderVertex LANDER_WINDOW[]  = { {3,15}, {4,11}, {0,12} };
+const LanderVertex LANDER_STORAGE[] = { {-1,7}, {-5,10}, {-5,12}, {-1,12} };
+
+/***********************************************************
+ * LANDER SHAPE
+ * The outline of the lander where it is and at its angle
+ ***********************************************************/
+class LanderShape
+{
+public:
+   // the legs, the engine, the thrusters, and the edge of the habitat
+   static const int MAX_SEGMENTS = 40;
+
+   LanderShape() : numSegments(0), left(0.0), right(0.0), bottom(0.0), top(0.0) {}
+   LanderShape(const Point & pt, double angle) { place(pt, angle); }
+
+   // turn the outline to angle and put the feet at pt
+   void place(const Point & pt, double angle);
+
+   // the line segments of the outline
+   int getNumSegments() const { return numSegments; }
+   const Point & getStart(int i) const { return starts[i]; }
+   const Point & getEnd(int i) const { return ends[i]; }
+
+   // the box around it all
+   double getLeft()   const { return left;   }
+   double getRight()  const { return right;  }
+   double getBottom() const { return bottom; }
+   double getTop()    const { return top;    }
+
+   // the two feet
+   const Point & getLeftFoot()  const { return feet[0]; }
+   const Point & getRightFoot() const { return feet[1]; }
+
+   // how far the outline reaches from the pivot, at any angle
+   static double getRadius();
+
+   // a vertex turned to angle about the pivot, and moved to pt
+   static Point rotate(const Point & pt, double x, double y, double cosA, double sinA)
+   {
+      y -= LANDER_PIVOT_Y;
+      return Point(pt.getX() + x * cosA - y * sinA,
+                   pt.getY() + y * cosA + x * sinA + LANDER_PIVOT_Y);
+   }
+
+private:
+   // the segments between the vertices, and back to the first if closed
+   void addOutline(const LanderVertex * vertices, int num, bool closed,
+                   const Point & pt, double cosA, double sinA);
+
+   Point starts[MAX_SEGMENTS];
+   Point ends[MAX_SEGMENTS];
+   int numSegments;
+   Point feet[2];
+   double left;
+   double right;
+   double bottom;
+   double top;
+};
@@ -0,0 +1,157 @@
+/***********************************************************************
+ * Source File:
+ *    Mapped File : A read-only file mapped into memory
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Map a whole file into our address space so it can be read like an
+ *    array. Nothing is read up front: the operating system brings the
+ *    pages in the first time they are touched.
+ ************************************************************************/
+
+#include "mappedFile.h"  // for the MappedFile class definition
+#include <utility>       // for std::swap()
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>    // for mmap()
+#include <sys/stat.h>    // for fstat()
+#include <fcntl.h>       // for open()
+#include <unistd.h>      // for close()
+#endif // _WIN32
+
+/************************************************************************
+ * MAPPED FILE constructor
+ ************************************************************************/
+MappedFile::MappedFile() : pData(NULL), numBytes(0)
+#ifdef _WIN32
+   , hFile(NULL), hMapping(NULL)
+#endif // _WIN32
+{
+}
+
+/************************************************************************
+ * SWAP
+ ************************************************************************/
+void MappedFile::swap(MappedFile & rhs)
+{
+   std::swap(pData, rhs.pData);
+   std::swap(numBytes, rhs.numBytes);
+#ifdef _WIN32
+   std::swap(hFile, rhs.hFile);
+   std::swap(hMapping, rhs.hMapping);
+#endif // _WIN32
+}
+
+#ifdef _WIN32
+
+/************************************************************************
+ * OPEN
+ * Map the file with CreateFileMapping()
+ ************************************************************************/
+bool MappedFile::open(const char * fileName)
+{
+   close();
+
+   HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+   if (file == INVALID_HANDLE_VALUE)
+      return false;
+
+   LARGE_INTEGER fileSize;
+   if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+   {
+      CloseHandle(file);
+      return false;
+   }
+
+   HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+   if (mapping == NULL)
+   {
+      CloseHandle(file);
+      return false;
+   }
+
+   const void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   if (view == NULL)
+   {
+      CloseHandle(mapping);
+      CloseHandle(file);
+      return false;
+   }
+
+   hFile = file;
+   hMapping = mapping;
+   pData = view;
+   numBytes = (size_t)fileSize.QuadPart;
+   return true;
+}
+
+/************************************************************************
+ * CLOSE
+ ************************************************************************/
+void MappedFile::close()
+{
+   if (pData != NULL)
+      UnmapViewOfFile(pData);
+   if (hMapping != NULL)
+      CloseHandle((HANDLE)hMapping);
+   if (hFile != NULL)
+      CloseHandle((HANDLE)hFile);
+
+   pData = NULL;
+   numBytes = 0;
+   hFile = NULL;
+   hMapping = NULL;
+}
+
+#else // !_WIN32
+
+/************************************************************************
+ * OPEN
+ * Map the file with mmap(). The descriptor can be closed right away;
+ * the mapping keeps the file alive
+ ************************************************************************/
+bool MappedFile::open(const char * fileName)
+{
+   close();
+
+   int fd = ::open(fileName, O_RDONLY);
+   if (fd < 0)
+      return false;
+
+   struct stat info;
+   if (fstat(fd, &info) != 0 || info.st_size <= 0)
+   {
+      ::close(fd);
+      return false;
+   }
+
+   void * view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+   ::close(fd);
+   if (view == MAP_FAILED)
+      return false;
+
+   // queries jump all over the file, so reading ahead does not help
+   madvise(view, (size_t)info.st_size, MADV_RANDOM);
+
+   pData = view;
+   numBytes = (size_t)info.st_size;
+   return true;
+}
+
+/************************************************************************
+ * CLOSE
+ ************************************************************************/
+void MappedFile::close()
+{
+   if (pData != NULL)
+      munmap(const_cast<void *>(pData), numBytes);
+
+   pData = NULL;
+   numBytes = 0;
+}
+
+#endif // _WIN32
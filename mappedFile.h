@@ -0,0 +1,50 @@
+/***********************************************************************
+ * Header File:
+ *    Mapped File : A read-only file mapped into memory
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Map a whole file into our address space so it can be read like an
+ *    array. Nothing is read up front: the operating system brings the
+ *    pages in the first time they are touched, so opening a huge file
+ *    is as fast as opening a small one.
+ ************************************************************************/
+
+#pragma once
+
+#include <cstddef>   // for size_t
+
+/***********************************************************
+ * MAPPED FILE
+ * A read-only view of a file
+ ***********************************************************/
+class MappedFile
+{
+public:
+   MappedFile();
+   ~MappedFile() { close(); }
+
+   // map the file. False if it cannot be opened or is empty
+   bool open(const char * fileName);
+
+   // unmap the file, if one is open
+   void close();
+
+   // trade mappings with another file
+   void swap(MappedFile & rhs);
+
+   bool isOpen()       const { return pData != NULL; }
+   const void * data() const { return pData;         }
+   size_t size()       const { return numBytes;      }
+
+private:
+   MappedFile(const MappedFile &);              // not copyable
+   MappedFile & operator = (const MappedFile &);
+
+   const void * pData;       // the start of the mapping
+   size_t numBytes;          // how big the file is
+#ifdef _WIN32
+   void * hFile;             // the file handle
+   void * hMapping;          // the file mapping handle
+#endif // _WIN32
+};
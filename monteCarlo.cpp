@@ -0,0 +1,187 @@
+/***********************************************************************
+ * Source File:
+ *    Monte Carlo : Score a controller over many random landings
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Run a controller against lots of randomized landings: new terrain
+ *    for every run, random starting positions and velocities, and noise
+ *    on the angle and the engine. The runs are spread over every core
+ *    and each thread keeps its own tally until the end.
+ ************************************************************************/
+
+#include "monteCarlo.h"  // for the Monte Carlo definitions
+#include "rng.h"         // for Random
+#include <cassert>
+#include <vector>        // for the tallies and the speeds
+
+const int GRAIN = 16;    // landings handed out at a time
+
+/************************************************************************
+ * MONTE CARLO CONFIG constructor
+ ************************************************************************/
+MonteCarloConfig::MonteCarloConfig() :
+   numSimulations(10000), maxSteps(5000), seed(0), ptUpperRight(1000.0, 1000.0),
+   policy(NULL), p(NULL),
+   xMin(0.1), xMax(0.9), yMin(0.6), yMax(0.9),
+   dxMin(-2.0), dxMax(2.0), dyMin(-2.0), dyMax(0.0),
+   angleNoise(0.0), thrustNoise(0.0)
+{
+}
+
+/************************************************************************
+ * MONTE CARLO RESULT constructor
+ ************************************************************************/
+MonteCarloResult::MonteCarloResult() :
+   simulations(0), landed(0), crashed(0), outOfFuel(0), timedOut(0),
+   steps(0), fuelLeft(0.0), touchdownSpeed(0.0), touchdownSpeedMax(0.0)
+{
+}
+
+/************************************************************************
+ * MONTE CARLO RESULT : MERGE
+ ************************************************************************/
+void MonteCarloResult::merge(const MonteCarloResult & rhs)
+{
+   simulations    += rhs.simulations;
+   landed         += rhs.landed;
+   crashed        += rhs.crashed;
+   outOfFuel      += rhs.outOfFuel;
+   timedOut       += rhs.timedOut;
+   steps          += rhs.steps;
+   fuelLeft       += rhs.fuelLeft;
+   touchdownSpeed += rhs.touchdownSpeed;
+   if (rhs.touchdownSpeedMax > touchdownSpeedMax)
+      touchdownSpeedMax = rhs.touchdownSpeedMax;
+}
+
+/*********************************************
+ * TALLY
+ * One thread's results, padded so two threads
+ * never share a cache line
+ *********************************************/
+struct Tally
+{
+   MonteCarloResult result;
+   char padding[64];
+};
+
+/*********************************************
+ * JOB
+ * Everything the workers need
+ *********************************************/
+struct Job
+{
+   const MonteCarloConfig * config;
+   Tally * tallies;
+   double * speeds;      // each landing's touchdown speed, 0 if none
+};
+
+/************************************************************************
+ * RUN LANDINGS
+ * Run landings [begin, end) and add them to this thread's tally
+ ************************************************************************/
+static void runLandings(int begin, int end, int thread, void * p)
+{
+   const Job & job = *(const Job *)p;
+   const MonteCarloConfig & config = *job.config;
+   MonteCarloResult & result = job.tallies[thread].result;
+
+   const double width  = config.ptUpperRight.getX();
+   const double height = config.ptUpperRight.getY();
+
+   // every landing has its own stream, so the results do not depend
+   // on which thread ran it. The first landing's world is made with
+   // the ground; the rest are made again in the same memory
+   Random rng(config.seed, (uint64_t)begin);
+   Ground ground(config.ptUpperRight, rng);
+   Simulator sim(ground);
+
+   for (int i = begin; i < end; i++)
+   {
+      // a new world and a new place to start
+      if (i != begin)
+      {
+         rng = Random(config.seed, (uint64_t)i);
+         ground.reset(rng);
+      }
+      LanderState state = sim.start(config.ptUpperRight);
+      state.x  = rng.nextDouble(config.xMin * width,  config.xMax * width);
+      state.y  = rng.nextDouble(config.yMin * height, config.yMax * height);
+      state.dx = rng.nextDouble(config.dxMin, config.dxMax);
+      state.dy = rng.nextDouble(config.dyMin, config.dyMax);
+
+      // fly until something happens
+      int step = 0;
+      while (step < config.maxSteps && state.status == FLYING)
+      {
+         LanderInput input = config.policy(state, config.p);
+         if (input.up && config.thrustNoise > 0.0 &&
+             rng.nextDouble() < config.thrustNoise)
+            input.up = false;
+
+         sim.step(state, input);
+         step++;
+
+         if (config.angleNoise > 0.0)
+            state.angle += rng.nextDouble(-config.angleNoise, config.angleNoise);
+      }
+
+      // keep score
+      result.simulations++;
+      result.steps += step;
+      if (state.fuel <= 0)
+         result.outOfFuel++;
+
+      job.speeds[i] = 0.0;
+      if (state.status == FLYING)
+      {
+         result.timedOut++;
+         continue;
+      }
+
+      if (state.status == LANDED)
+      {
+         result.landed++;
+         result.fuelLeft += state.fuel;
+      }
+      else
+         result.crashed++;
+
+      // summed at the end in landing order, since the sum of doubles
+      // depends on the order they are added in
+      double speed = sim.getSpeed(state);
+      job.speeds[i] = speed;
+      if (speed > result.touchdownSpeedMax)
+         result.touchdownSpeedMax = speed;
+   }
+}
+
+/************************************************************************
+ * EVALUATE
+ * Run all the landings in the config on the given pool, then merge
+ * the per-thread tallies. The counts are the same however the work was
+ * split; the touchdown speeds are added up in landing order so their
+ * sum is too
+ ************************************************************************/
+MonteCarloResult evaluate(const MonteCarloConfig & config, ThreadPool & pool)
+{
+   assert(config.policy != NULL);
+   assert(config.numSimulations >= 0);
+
+   std::vector<Tally> tallies(pool.size());
+   std::vector<double> speeds(config.numSimulations);
+   Job job;
+   job.config = &config;
+   job.tallies = &tallies[0];
+   job.speeds = speeds.data();
+
+   pool.parallelFor(config.numSimulations, GRAIN, runLandings, &job);
+
+   MonteCarloResult result;
+   for (size_t i = 0; i < tallies.size(); i++)
+      result.merge(tallies[i].result);
+   for (size_t i = 0; i < speeds.size(); i++)
+      result.touchdownSpeed += speeds[i];
+   return result;
+}
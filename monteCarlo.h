@@ -0,0 +1,78 @@
+/***********************************************************************
+ * Header File:
+ *    Monte Carlo : Score a controller over many random landings
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Run a controller against lots of randomized landings: new terrain
+ *    for every run, random starting positions and velocities, and noise
+ *    on the angle and the engine. The runs are spread over every core
+ *    and each thread keeps its own tally until the end.
+ ************************************************************************/
+
+#pragma once
+
+#include "simulator.h"   // for the Simulator and LanderState
+#include "threadPool.h"  // to spread the work around
+
+/*********************************************
+ * MONTE CARLO CONFIG
+ * What to run and how much to randomize it
+ *********************************************/
+struct MonteCarloConfig
+{
+   MonteCarloConfig();
+
+   int    numSimulations;  // how many landings
+   int    maxSteps;        // give up on a landing after this many steps
+   uint64_t seed;          // the same seed always gives the same landings
+   Point  ptUpperRight;    // the size of the world
+
+   // the controller being evaluated
+   LanderInput (*policy)(const LanderState &, void *);
+   void * p;
+
+   // the starting state is chosen from these ranges
+   double xMin, xMax;      // as a fraction of the width
+   double yMin, yMax;      // as a fraction of the height
+   double dxMin, dxMax;
+   double dyMin, dyMax;
+
+   double angleNoise;      // radians added or removed every step
+   double thrustNoise;     // chance the engine fails to light on a step
+};
+
+/*********************************************
+ * MONTE CARLO RESULT
+ * The tally of a bunch of landings
+ *********************************************/
+struct MonteCarloResult
+{
+   MonteCarloResult();
+
+   // fold in somebody else's tally
+   void merge(const MonteCarloResult & rhs);
+
+   double landedRate()     const { return simulations ? (double)landed / simulations : 0.0; }
+   double averageFuel()    const { return landed ? fuelLeft / landed : 0.0; }
+   double averageTouchdown() const
+   {
+      return (landed + crashed) ? touchdownSpeed / (landed + crashed) : 0.0;
+   }
+
+   long long simulations;    // how many landings were tried
+   long long landed;         // safely on the platform
+   long long crashed;        // hit the ground
+   long long outOfFuel;      // the tank was empty at the end
+   long long timedOut;       // still flying after maxSteps
+   long long steps;          // total steps simulated
+   double fuelLeft;          // fuel left over, summed over the landings
+   double touchdownSpeed;    // speed at contact, summed over contacts
+   double touchdownSpeedMax; // the hardest contact
+};
+
+/******************************************************************
+ * EVALUATE
+ * Run all the landings in the config on the given pool
+ ****************************************************************/
+MonteCarloResult evaluate(const MonteCarloConfig & config, ThreadPool & pool);
@@ -6,6 +6,8 @@
 
 using namespace std;
 
+const double PI = 3.14159265358979323846;  // what 2 asin(1) works out to
+
 physics::physics()
 {
 	timer = 0;
@@ -142,6 +144,5 @@ double physics::computeTotalComponent(double x, double y)
 }
 double physics::radiansFromDegrees(double d)
 {
-	double pi = 2 * asin(1.0);
-	return (d * (2 * pi)) / 360;
+	return (d * (2 * PI)) / 360;
 }
@@ -1,3 +1,5 @@
+#pragma once
+
 class physics {
 public:
     double timer;
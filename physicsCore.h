@@ -0,0 +1,287 @@
+/***********************************************************************
+ * Header File:
+ *    Physics Core : The lander's step, fixed at compile time
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    The kinematics of the Simulator as a template. The moon, the
+ *    lander and the length of a step are types holding constants, and
+ *    everything worked out from them (the engine's acceleration, t^2/2,
+ *    degrees to radians) is a constant expression, so none of it is
+ *    computed while the game runs. The numbers can be double, float, or
+ *    Fixed:
+ *
+ *       double  the same answers as the Simulator, bit for bit
+ *       float   twice as many landers per vector register, for batch
+ *               runs where six or seven digits are enough
+ *       Fixed   32.32 fixed point: the same answer on every machine
+ *               and compiler, since there is no floating point to round
+ *               differently. Only sine, cosine and square root go
+ *               through double
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>       // for int64_t
+#include <cmath>         // for sin(), cos() and sqrt()
+#include "simulator.h"   // for LanderState, LanderInput, and Ground
+
+/*********************************************
+ * MOON, LUNAR MODULE and TENTH SECOND
+ * Where we land, what we land with, and how
+ * long a step is. The game's own numbers
+ *********************************************/
+struct Moon
+{
+   static constexpr double GRAVITY = ::GRAVITY;
+};
+
+struct LunarModule
+{
+   static constexpr double THRUST      = ::THRUST;
+   static constexpr double WEIGHT      = ::WEIGHT;
+   static constexpr double ROTATE      = ::ROTATE;
+   static constexpr int    FUEL_ROTATE = ::FUEL_ROTATE;
+   static constexpr int    FUEL_THRUST = ::FUEL_THRUST;
+   static constexpr int    FUEL        = 5000;          // in a full tank
+   static constexpr int    WIDTH       = LANDER_WIDTH;
+};
+
+struct TenthSecond
+{
+   static constexpr double TIME = 0.1;
+};
+
+/***********************************************************
+ * FIXED
+ * A 32.32 fixed point number: the low 32 bits are the
+ * fraction. Good for +/- two billion to ten decimal places
+ ***********************************************************/
+class Fixed
+{
+public:
+   constexpr Fixed() : raw(0) {}
+   constexpr Fixed(double d) :
+      raw((int64_t)(d * ONE + (d < 0.0 ? -0.5 : 0.5))) {}
+   constexpr Fixed(int i) : raw((int64_t)i * (int64_t)ONE) {}
+
+   constexpr double toDouble() const { return (double)raw / ONE; }
+   static constexpr Fixed fromRaw(int64_t raw) { return Fixed(raw, 0); }
+   constexpr int64_t getRaw() const { return raw; }
+
+   constexpr Fixed operator - () const { return fromRaw(-raw); }
+   constexpr Fixed operator + (Fixed rhs) const { return fromRaw(raw + rhs.raw); }
+   constexpr Fixed operator - (Fixed rhs) const { return fromRaw(raw - rhs.raw); }
+   constexpr Fixed operator * (Fixed rhs) const { return fromRaw(multiply(raw, rhs.raw)); }
+   Fixed & operator += (Fixed rhs) { raw += rhs.raw; return *this; }
+   Fixed & operator -= (Fixed rhs) { raw -= rhs.raw; return *this; }
+
+   constexpr bool operator <  (Fixed rhs) const { return raw <  rhs.raw; }
+   constexpr bool operator <= (Fixed rhs) const { return raw <= rhs.raw; }
+   constexpr bool operator >  (Fixed rhs) const { return raw >  rhs.raw; }
+   constexpr bool operator >= (Fixed rhs) const { return raw >= rhs.raw; }
+   constexpr bool operator == (Fixed rhs) const { return raw == rhs.raw; }
+   constexpr bool operator != (Fixed rhs) const { return raw != rhs.raw; }
+
+private:
+   static constexpr double ONE = 4294967296.0;   // 2^32
+
+   constexpr Fixed(int64_t raw, int) : raw(raw) {}
+
+   // (a b) / 2^32 from 32-bit halves, rounded half away from zero.
+   // No 128-bit type, so every compiler rounds it the same way
+   static constexpr int64_t multiply(int64_t a, int64_t b)
+   {
+      return (a < 0) != (b < 0) ?
+         -(int64_t)multiplyUnsigned(magnitude(a), magnitude(b)) :
+          (int64_t)multiplyUnsigned(magnitude(a), magnitude(b));
+   }
+
+   static constexpr uint64_t magnitude(int64_t a)
+   {
+      return a < 0 ? 0 - (uint64_t)a : (uint64_t)a;
+   }
+
+   static constexpr uint64_t multiplyUnsigned(uint64_t a, uint64_t b)
+   {
+      return ((a >> 32) * (b >> 32) << 32) +
+             (a >> 32) * (b & 0xffffffff) +
+             (a & 0xffffffff) * (b >> 32) +
+             (((a & 0xffffffff) * (b & 0xffffffff) + 0x80000000) >> 32);
+   }
+
+   int64_t raw;
+};
+
+/******************************************************************
+ * CORE MATH
+ * What the step needs from a number type beyond + - and *
+ ****************************************************************/
+inline double coreSin(double a)  { return std::sin(a);  }
+inline double coreCos(double a)  { return std::cos(a);  }
+inline double coreSqrt(double a) { return std::sqrt(a); }
+inline double coreDouble(double a) { return a; }
+
+inline float coreSin(float a)  { return std::sin(a);  }
+inline float coreCos(float a)  { return std::cos(a);  }
+inline float coreSqrt(float a) { return std::sqrt(a); }
+inline double coreDouble(float a) { return (double)a; }
+
+inline Fixed coreSin(Fixed a)  { return Fixed(std::sin(a.toDouble()));  }
+inline Fixed coreCos(Fixed a)  { return Fixed(std::cos(a.toDouble()));  }
+inline Fixed coreSqrt(Fixed a) { return Fixed(std::sqrt(a.toDouble())); }
+inline double coreDouble(Fixed a) { return a.toDouble(); }
+
+/*********************************************
+ * CORE STATE
+ * A LanderState in some number type
+ *********************************************/
+template <class T>
+struct CoreState
+{
+   CoreState() : x(), y(), dx(), dy(), angle(), thrust(), fuel(0), status(FLYING) {}
+   CoreState(const LanderState & s) :
+      x(T(s.x)), y(T(s.y)), dx(T(s.dx)), dy(T(s.dy)), angle(T(s.angle)),
+      thrust(T(s.thrust)), fuel(s.fuel), status(s.status) {}
+
+   LanderState toLanderState() const
+   {
+      LanderState s;
+      s.x      = coreDouble(x);
+      s.y      = coreDouble(y);
+      s.dx     = coreDouble(dx);
+      s.dy     = coreDouble(dy);
+      s.angle  = coreDouble(angle);
+      s.thrust = coreDouble(thrust);
+      s.fuel   = fuel;
+      s.status = status;
+      return s;
+   }
+
+   T x;
+   T y;
+   T dx;
+   T dy;
+   T angle;
+   T thrust;
+   int fuel;
+   LanderStatus status;
+};
+
+/***********************************************************
+ * PHYSICS CORE
+ * The step of the Simulator's game scheme, in number
+ * type T, for a vehicle on a body with a fixed step
+ ***********************************************************/
+template <class T, class Body = Moon, class Vehicle = LunarModule,
+          class Step = TenthSecond>
+class PhysicsCore
+{
+public:
+   // the constants, in T
+   static constexpr T gravity()   { return T(Body::GRAVITY);                  }
+   static constexpr T engine()    { return T(Vehicle::THRUST / Vehicle::WEIGHT); }
+   static constexpr T rotate()    { return T(Vehicle::ROTATE);                }
+   static constexpr T time()      { return T(Step::TIME);                     }
+   static constexpr T halfTime2() { return T(0.5 * (Step::TIME * Step::TIME)); }
+   static constexpr T radiansPerDegree() { return T(3.14159265358979323846 / 180.0); }
+
+   static constexpr T radiansFromDegrees(T degrees) { return degrees * radiansPerDegree(); }
+
+   // a full tank at the top right of the world
+   static CoreState<T> start(const Point & ptUpperRight)
+   {
+      CoreState<T> s;
+      s.x = T(ptUpperRight.getX() - 100.0);
+      s.y = T(ptUpperRight.getY() - 80.0);
+      s.fuel = Vehicle::FUEL;
+      return s;
+   }
+
+   // fly one step with no ground to hit. The same operations in the
+   // same order as Simulator::step(), so double gives the same bits
+   static void move(CoreState<T> & s, const LanderInput & input)
+   {
+      constexpr T ENGINE = engine();
+      constexpr T GRAVITY_T = gravity();
+      constexpr T ROTATE_T = rotate();
+      constexpr T TIME_T = time();
+      constexpr T HALF_TIME2 = halfTime2();
+
+      if (s.status != FLYING)
+         return;
+
+      // the acceleration comes from the engine as it was during the last step
+      T ddx = s.thrust * coreSin(s.angle);
+      T ddy = s.thrust * coreCos(s.angle) + GRAVITY_T;
+
+      // respond to the controls
+      if (s.fuel > 0)
+      {
+         if (input.right)
+         {
+            s.fuel -= Vehicle::FUEL_ROTATE;
+            s.angle = s.angle - ROTATE_T;
+         }
+         if (input.left)
+         {
+            s.fuel -= Vehicle::FUEL_ROTATE;
+            s.angle = s.angle + ROTATE_T;
+         }
+         if (input.up)
+         {
+            s.fuel -= Vehicle::FUEL_THRUST;
+            if (s.fuel < 0)
+               s.fuel = 0;
+            s.thrust = ENGINE;
+         }
+         else
+            s.thrust = T();
+      }
+      else
+         s.thrust = T();
+
+      // the new velocity, then the position with it
+      s.dx = s.dx + ddx * TIME_T;
+      s.dy = s.dy + ddy * TIME_T;
+      s.x = s.x + (-s.dx) * TIME_T + ddx * HALF_TIME2;
+      s.y = s.y + s.dy * TIME_T + ddy * HALF_TIME2;
+   }
+
+   // fly one step and see what it hit
+   static LanderStatus step(CoreState<T> & s, const LanderInput & input,
+                            const Ground & ground)
+   {
+      if (s.status != FLYING)
+         return s.status;
+      move(s, input);
+
+      Point ptLM(coreDouble(s.x), coreDouble(s.y));
+      if (ground.hitGround(ptLM, Vehicle::WIDTH))
+         s.status = CRASHED;
+
+      if (ground.onPlatform(ptLM, Vehicle::WIDTH))
+      {
+         if (s.dy <= T(4.0) && s.dx <= T(2.0))
+            s.status = LANDED;
+         else if (speed(s) > T(4.0))
+            s.status = CRASHED;
+      }
+      return s.status;
+   }
+
+   // many landers with no ground, for the batch runs
+   static void move(CoreState<T> * states, const LanderInput * inputs, int num)
+   {
+      for (int i = 0; i < num; i++)
+         move(states[i], inputs[i]);
+   }
+
+   static T speed(const CoreState<T> & s)
+   {
+      return coreSqrt(s.dx * s.dx + s.dy * s.dy);
+   }
+};
+
+// the game's own physics
+typedef PhysicsCore<double> LunarPhysics;
@@ -0,0 +1,235 @@
+/***********************************************************************
+ * Source File:
+ *    Profiler : Where does the frame go?
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Per-thread rings of timed phases, and what can be made from them:
+ *    percentiles, an overlay, and a Chrome trace.
+ ************************************************************************/
+
+#include "profiler.h"    // for the Profiler class definition
+#include "uiDraw.h"      // for drawing the overlay
+#include <chrono>
+#include <mutex>
+#include <memory>        // for unique_ptr
+#include <algorithm>     // for sort()
+#include <cstring>       // for strcmp()
+#include <cstdio>        // for FILE and snprintf()
+#include <cassert>
+using namespace std;
+
+/*********************************************
+ * RING
+ * The last RING_SIZE phases one thread timed.
+ * Only the owning thread writes; anyone may
+ * read, checking head to see what was
+ * overwritten while they looked
+ *********************************************/
+struct Profiler::Ring
+{
+   Ring(int thread) : head(0), thread(thread) { }
+
+   ProfileEvent events[RING_SIZE];
+   atomic<uint64_t> head;         // how many events ever written
+   int thread;                    // which thread, in order of first use
+};
+
+namespace
+{
+   typedef chrono::steady_clock Clock;
+   const Clock::time_point epoch = Clock::now();
+
+   // every ring ever made. Rings outlive their threads so a trace
+   // can still be written after a thread is gone
+   mutex ringsLock;
+   vector<unique_ptr<Profiler::Ring> > rings;
+
+   /************************************************************************
+    * PERCENTILE
+    * The duration p of the way through the sorted durations, in ms
+    ************************************************************************/
+   double percentile(const vector<int64_t> & sorted, double p)
+   {
+      assert(!sorted.empty());
+      size_t i = (size_t)(p * sorted.size());
+      if (i >= sorted.size())
+         i = sorted.size() - 1;
+      return sorted[i] / 1.0e6;
+   }
+}
+
+/************************************************************************
+ * NOW
+ ************************************************************************/
+int64_t Profiler::now()
+{
+   return chrono::duration_cast<chrono::nanoseconds>(Clock::now() - epoch).count();
+}
+
+/************************************************************************
+ * RING
+ * The calling thread's ring, made the first time it is needed
+ ************************************************************************/
+Profiler::Ring & Profiler::ring()
+{
+   thread_local Ring * pRing = NULL;
+   if (pRing == NULL)
+   {
+      lock_guard<mutex> guard(ringsLock);
+      rings.push_back(unique_ptr<Ring>(new Ring((int)rings.size())));
+      pRing = rings.back().get();
+   }
+   return *pRing;
+}
+
+/************************************************************************
+ * RECORD
+ * Nobody else writes to this ring, so there is nothing to wait for
+ ************************************************************************/
+void Profiler::record(const char * name, int64_t start, int64_t duration)
+{
+   Ring & mine = ring();
+   uint64_t h = mine.head.load(memory_order_relaxed);
+   ProfileEvent & event = mine.events[h & (RING_SIZE - 1)];
+   event.name = name;
+   event.start = start;
+   event.duration = duration;
+   mine.head.store(h + 1, memory_order_release);
+}
+
+/************************************************************************
+ * COPY
+ * Take what is in a ring while its thread keeps writing. Anything the
+ * thread may have written over while we were copying is thrown out
+ ************************************************************************/
+void Profiler::copy(const Ring & ring, vector<ProfileEvent> & events)
+{
+   uint64_t end = ring.head.load(memory_order_acquire);
+   uint64_t begin = end > RING_SIZE ? end - RING_SIZE : 0;
+
+   size_t first = events.size();
+   for (uint64_t i = begin; i < end; i++)
+      events.push_back(ring.events[i & (RING_SIZE - 1)]);
+
+   // the slot for the event being written now may also be torn
+   atomic_thread_fence(memory_order_acquire);
+   uint64_t after = ring.head.load(memory_order_relaxed);
+   if (after + 1 > begin + RING_SIZE)
+   {
+      uint64_t lost = after + 1 - (begin + RING_SIZE);
+      if (lost > end - begin)
+         lost = end - begin;
+      events.erase(events.begin() + first, events.begin() + first + lost);
+   }
+}
+
+/************************************************************************
+ * SUMMARIZE
+ * Sort every phase that ended in the window by name, then by how long
+ * it took, and read off the percentiles
+ ************************************************************************/
+void Profiler::summarize(vector<PhaseStats> & stats, double window)
+{
+   vector<ProfileEvent> events;
+   {
+      lock_guard<mutex> guard(ringsLock);
+      for (size_t i = 0; i < rings.size(); i++)
+         copy(*rings[i], events);
+   }
+
+   int64_t cutoff = now() - (int64_t)(window * 1.0e9);
+   vector<const char *> names;
+   vector<vector<int64_t> > durations;
+   for (size_t i = 0; i < events.size(); i++)
+   {
+      if (events[i].start + events[i].duration < cutoff)
+         continue;
+
+      size_t iName = 0;
+      while (iName < names.size() && strcmp(names[iName], events[i].name) != 0)
+         iName++;
+      if (iName == names.size())
+      {
+         names.push_back(events[i].name);
+         durations.push_back(vector<int64_t>());
+      }
+      durations[iName].push_back(events[i].duration);
+   }
+
+   stats.clear();
+   for (size_t i = 0; i < names.size(); i++)
+   {
+      sort(durations[i].begin(), durations[i].end());
+      PhaseStats phase;
+      phase.name  = names[i];
+      phase.count = (int)durations[i].size();
+      phase.p50   = percentile(durations[i], 0.50);
+      phase.p95   = percentile(durations[i], 0.95);
+      phase.p99   = percentile(durations[i], 0.99);
+      phase.max   = durations[i].back() / 1.0e6;
+      stats.push_back(phase);
+   }
+
+   sort(stats.begin(), stats.end(),
+        [](const PhaseStats & lhs, const PhaseStats & rhs) { return lhs.p95 > rhs.p95; });
+}
+
+/************************************************************************
+ * DRAW OVERLAY
+ * One line per phase:  name  count  p50  p95  p99  max
+ ************************************************************************/
+void Profiler::drawOverlay(ogstream & gout, const Point & pt, double window)
+{
+   vector<PhaseStats> stats;
+   summarize(stats, window);
+
+   char line[128];
+   gout.setPosition(pt);
+   gout << "phase          n    p50    p95    p99    max ms\n";
+   for (size_t i = 0; i < stats.size(); i++)
+   {
+      snprintf(line, sizeof(line), "%-12.12s %4d %6.2f %6.2f %6.2f %6.2f\n",
+               stats[i].name, stats[i].count,
+               stats[i].p50, stats[i].p95, stats[i].p99, stats[i].max);
+      gout << line;
+   }
+}
+
+/************************************************************************
+ * WRITE TRACE
+ * Complete ("X") events in the Trace Event Format, times in
+ * microseconds, one track per thread
+ ************************************************************************/
+bool Profiler::writeTrace(const char * fileName)
+{
+   assert(fileName != NULL);
+   FILE * file = fopen(fileName, "w");
+   if (file == NULL)
+      return false;
+
+   fprintf(file, "{\"traceEvents\":[\n");
+   bool first = true;
+
+   lock_guard<mutex> guard(ringsLock);
+   vector<ProfileEvent> events;
+   for (size_t iRing = 0; iRing < rings.size(); iRing++)
+   {
+      int thread = rings[iRing]->thread;
+      fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                    "\"args\":{\"name\":\"thread %d\"}}",
+              first ? "" : ",\n", thread, thread);
+      first = false;
+
+      events.clear();
+      copy(*rings[iRing], events);
+      for (size_t i = 0; i < events.size(); i++)
+         fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                       "\"ts\":%.3f,\"dur\":%.3f}",
+                 events[i].name, thread,
+                 events[i].start / 1000.0, events[i].duration / 1000.0);
+   }
+
+   fprintf(file, "\n]}\n");
+   return fclose(file) == 0;
+}
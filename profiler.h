@@ -0,0 +1,106 @@
+/***********************************************************************
+ * Header File:
+ *    Profiler : Where does the frame go?
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Time named phases of the program with PROFILE_SCOPE("name"). Each
+ *    thread writes its timings into a ring of its own with no locks, so
+ *    timing a phase costs two reads of steady_clock and one store. The
+ *    recent timings can be summarized as percentiles, drawn on top of
+ *    the game, or written out as a trace that chrome://tracing and
+ *    Perfetto can open.
+ *
+ *    Nothing is timed unless the program is built with PROFILE defined.
+ *    Without it PROFILE_SCOPE expands to nothing at all.
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>   // for int64_t and uint64_t
+
+class ogstream;
+class Point;
+
+/*********************************************
+ * PROFILE EVENT
+ * One phase, once. Times are in nanoseconds
+ * since the profiler started
+ *********************************************/
+struct ProfileEvent
+{
+   const char * name;        // must live forever: use a string literal
+   int64_t start;
+   int64_t duration;
+};
+
+/*********************************************
+ * PHASE STATS
+ * How long one phase took recently, in
+ * milliseconds
+ *********************************************/
+struct PhaseStats
+{
+   const char * name;
+   int    count;             // times it ran in the window
+   double p50;
+   double p95;
+   double p99;
+   double max;
+};
+
+/***********************************************************
+ * PROFILER
+ * The rings of every thread that has timed something
+ ***********************************************************/
+class Profiler
+{
+public:
+   static const int RING_SIZE = 4096;   // events kept per thread, a power of two
+
+   // nanoseconds since the profiler started
+   static int64_t now();
+
+   // remember one phase on the calling thread's ring
+   static void record(const char * name, int64_t start, int64_t duration);
+
+   // the phases that finished in the last window seconds, slowest first
+   static void summarize(std::vector<PhaseStats> & stats, double window = 1.0);
+
+   // the summary as text, starting at the top left corner pt
+   static void drawOverlay(ogstream & gout, const Point & pt, double window = 1.0);
+
+   // everything still in the rings as Chrome trace event JSON
+   static bool writeTrace(const char * fileName);
+
+   struct Ring;              // one thread's events, see profiler.cpp
+
+private:
+   static Ring & ring();
+   static void copy(const Ring & ring, std::vector<ProfileEvent> & events);
+};
+
+/***********************************************************
+ * PROFILE SCOPE
+ * Time from here to the end of the block
+ ***********************************************************/
+class ProfileScope
+{
+public:
+   ProfileScope(const char * name) : name(name), start(Profiler::now()) { }
+   ~ProfileScope() { Profiler::record(name, start, Profiler::now() - start); }
+
+private:
+   const char * name;
+   int64_t start;
+};
+
+#ifdef PROFILE
+#define PROFILE_JOIN2(a, b) a ## b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_JOIN(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif // PROFILE
@@ -0,0 +1,168 @@
+/***********************************************************************
+ * Source File:
+ *    Range Max : The highest value over any range, in constant time
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    An index over an array of doubles that answers "what is the
+ *    largest value in [lo, hi]?" without scanning the range.
+ ************************************************************************/
+
+#include "rangeMax.h"  // for the RangeMax class definition
+#include <cassert>
+
+const int RangeMax::BLOCK;
+
+/************************************************************************
+ * LOG 2
+ * The position of the highest set bit
+ ************************************************************************/
+static inline int log2Floor(unsigned int value)
+{
+   assert(value > 0);
+   int log = 0;
+   while (value >>= 1)
+      log++;
+   return log;
+}
+
+/************************************************************************
+ * TABLE SIZE
+ * How many doubles the tables take for n values
+ ************************************************************************/
+size_t RangeMax::tableSize(int n)
+{
+   if (n <= 0)
+      return 0;
+   int numBlocks = (n + BLOCK - 1) / BLOCK;
+   int numLevels = log2Floor((unsigned int)numBlocks) + 1;
+   return (size_t)2 * n + (size_t)numLevels * numBlocks;
+}
+
+/************************************************************************
+ * LAYOUT
+ * Work out the sizes and where each table starts
+ ************************************************************************/
+void RangeMax::layout(int n)
+{
+   this->n = n;
+   numBlocks = (n + BLOCK - 1) / BLOCK;
+   numLevels = (n > 0 ? log2Floor((unsigned int)numBlocks) + 1 : 0);
+   prefix = tables;
+   suffix = tables + n;
+   sparse = tables + 2 * (size_t)n;
+}
+
+/************************************************************************
+ * BUILD
+ * Fill in the tables for data[0..n)
+ ************************************************************************/
+void RangeMax::build(const double * data, int n)
+{
+   assert(n >= 0);
+   assert(data != NULL || n == 0);
+
+   this->data = data;
+   storage.resize(tableSize(n));
+   tables = storage.empty() ? NULL : &storage[0];
+   layout(n);
+   if (n == 0)
+      return;
+
+   double * pre = &storage[0];
+   double * suf = pre + n;
+   double * top = suf + n;
+
+   // running maximums within each block
+   for (int b = 0; b < numBlocks; b++)
+   {
+      int begin = b * BLOCK;
+      int end = (begin + BLOCK < n ? begin + BLOCK : n);
+
+      pre[begin] = data[begin];
+      for (int i = begin + 1; i < end; i++)
+         pre[i] = (data[i] > pre[i - 1] ? data[i] : pre[i - 1]);
+
+      suf[end - 1] = data[end - 1];
+      for (int i = end - 2; i >= begin; i--)
+         suf[i] = (data[i] > suf[i + 1] ? data[i] : suf[i + 1]);
+
+      // the whole block is the first row of the sparse table
+      top[b] = pre[end - 1];
+   }
+
+   // each row covers twice as many blocks as the one before
+   for (int k = 1; k < numLevels; k++)
+   {
+      const double * below = top + (size_t)(k - 1) * numBlocks;
+      double * row = top + (size_t)k * numBlocks;
+      int half = 1 << (k - 1);
+      for (int b = 0; b + (1 << k) <= numBlocks; b++)
+         row[b] = (below[b] > below[b + half] ? below[b] : below[b + half]);
+   }
+}
+
+/************************************************************************
+ * ATTACH
+ * Use tables somebody else built with the same layout
+ ************************************************************************/
+void RangeMax::attach(const double * data, int n, const double * tables)
+{
+   assert(n >= 0);
+   storage.clear();
+   this->data = data;
+   this->tables = tables;
+   layout(n);
+}
+
+/************************************************************************
+ * MAX
+ * The largest value in data[lo..hi]
+ ************************************************************************/
+double RangeMax::max(int lo, int hi) const
+{
+   assert(0 <= lo && lo <= hi && hi < n);
+
+   int blockLo = lo / BLOCK;
+   int blockHi = hi / BLOCK;
+
+   // both ends in the same block: a short scan
+   if (blockLo == blockHi)
+   {
+      double value = data[lo];
+      for (int i = lo + 1; i <= hi; i++)
+         if (data[i] > value)
+            value = data[i];
+      return value;
+   }
+
+   // the partial blocks on either end
+   double value = (suffix[lo] > prefix[hi] ? suffix[lo] : prefix[hi]);
+
+   // the whole blocks in between, covered by two overlapping rows
+   if (blockHi - blockLo > 1)
+   {
+      int first = blockLo + 1;
+      int last = blockHi - 1;
+      int k = log2Floor((unsigned int)(last - first + 1));
+      const double * row = sparse + (size_t)k * numBlocks;
+      double left = row[first];
+      double right = row[last - (1 << k) + 1];
+      if (left > value)
+         value = left;
+      if (right > value)
+         value = right;
+   }
+
+   return value;
+}
+
+/************************************************************************
+ * MAX
+ * Many queries at once
+ ************************************************************************/
+void RangeMax::max(const int * lo, const int * hi, double * out, int num) const
+{
+   for (int i = 0; i < num; i++)
+      out[i] = max(lo[i], hi[i]);
+}
@@ -0,0 +1,66 @@
+/***********************************************************************
+ * Header File:
+ *    Range Max : The highest value over any range, in constant time
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    An index over an array of doubles that answers "what is the
+ *    largest value in [lo, hi]?" without scanning the range. The array
+ *    is cut into small blocks. Each element knows the largest value
+ *    from the start of its block and to the end of its block, and a
+ *    sparse table knows the largest value over any run of whole blocks.
+ *    A query is then at most three lookups, or a scan of a single
+ *    block when both ends land in the same one.
+ ************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <cstddef>   // for size_t
+
+/***********************************************************
+ * RANGE MAX
+ * A static range-maximum index
+ ***********************************************************/
+class RangeMax
+{
+public:
+   static const int BLOCK = 16;      // elements per block
+
+   RangeMax() : data(NULL), tables(NULL), n(0), numBlocks(0), numLevels(0) {}
+
+   // build the index over data[0..n). The data is not copied, so it
+   // must outlive the index or be rebuilt
+   void build(const double * data, int n);
+
+   // the largest value in data[lo..hi], inclusive. lo <= hi
+   double max(int lo, int hi) const;
+
+   // many queries at once: out[i] = max(lo[i], hi[i])
+   void max(const int * lo, const int * hi, double * out, int num) const;
+
+   // the tables, so they can be written to disk
+   const double * getTables() const { return tables; }
+   static size_t tableSize(int n);  // number of doubles in the tables
+
+   // use tables somebody else built, such as from a mapped file
+   void attach(const double * data, int n, const double * tables);
+
+   int size() const { return n; }
+
+private:
+   RangeMax(const RangeMax &);              // not copyable
+   RangeMax & operator = (const RangeMax &);
+
+   void layout(int n);
+
+   const double * data;      // the values being indexed
+   const double * tables;    // prefix, suffix, then the sparse table
+   const double * prefix;    // max from the start of the block to i
+   const double * suffix;    // max from i to the end of the block
+   const double * sparse;    // sparse[k * numBlocks + b] = max of 2^k blocks
+   int n;                    // number of values
+   int numBlocks;            // number of blocks
+   int numLevels;            // number of rows in the sparse table
+   std::vector<double> storage;  // the tables when we built them
+};
@@ -0,0 +1,688 @@
+/***********************************************************************
+ * Source File:
+ *    Regression : Did that change move the lander?
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    A program of its own, separate from the game, that flies a few
+ *    thousand landers from fixed seeds with scripted controls and hashes
+ *    the whole lander state after every step. "record" saves those hash
+ *    streams as the golden run. "verify" flies the same landers again
+ *    and reports the first step where any of them went somewhere else.
+ *    Every scenario is independent so they are spread over a ThreadPool,
+ *    and nothing is drawn. The landers are moved with the game's own
+ *    integrator and collide at the end of each step unless something
+ *    else is chosen when recording; the golden file remembers what, and
+ *    verify uses the same. The golden file also keeps the hash of a
+ *    frame drawn by the SoftwareRenderer, the first scenario where it
+ *    ended, so a change to the drawing or the rasterizer shows up too.
+ *    --frame saves that frame as a PPM image to look at.
+ *
+ *    "history" needs no golden file. It flies the landers into a
+ *    gameHistory, reads every frame back forward and backward, rewinds,
+ *    pushes other frames, and reads them all back again. Every frame has
+ *    to come back bit for bit.
+ *
+ *    regression record FILE [--scenarios N] [--steps N] [--seed N]
+ *                           [--integrator game|semi|verlet|rk4|rk45]
+ *                           [--swept] [--polygon] [--frame PPM]
+ *    regression verify FILE [--report N] [--frame PPM]
+ *    regression history [--scenarios N] [--steps N] [--seed N] [--report N]
+ ************************************************************************/
+
+#include "simulator.h"
+#include "ground.h"
+#include "rng.h"
+#include "threadPool.h"
+#include "mappedFile.h"
+#include "gameState.hpp"
+#include "softwareRenderer.h"
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>     // for atoi() and strtoull()
+#include <cstring>     // for memcpy(), memcmp() and strcmp()
+#include <cstdint>
+#include <cassert>
+#include <cmath>       // for sqrt()
+using namespace std;
+
+const int      DEFAULT_SCENARIOS = 2048;
+const int      DEFAULT_STEPS     = 1000;    // the most steps one lander flies
+const uint64_t DEFAULT_SEED      = 1969;    // the first scenario's seed
+const int      DEFAULT_REPORT    = 10;      // divergent scenarios to describe
+const long     HISTORY_FRAMES    = 300;     // small, so old frames are forgotten
+
+const double   WORLD_WIDTH  = 1000.0;       // the same size as the game
+const double   WORLD_HEIGHT = 1000.0;
+
+// what --integrator calls each IntegratorType
+const char * const INTEGRATOR_NAMES[] = { "game", "semi", "verlet", "rk4", "rk45" };
+const int NUM_INTEGRATORS = sizeof(INTEGRATOR_NAMES) / sizeof(INTEGRATOR_NAMES[0]);
+
+// how the landers find the ground, as bits in the golden header
+const uint32_t COLLIDE_SWEPT   = 0x1;     // along the whole step
+const uint32_t COLLIDE_POLYGON = 0x2;     // the outline, at its angle
+const uint32_t COLLIDE_ALL     = COLLIDE_SWEPT | COLLIDE_POLYGON;
+
+/*********************************************
+ * MODE
+ * How the Simulator is set up for every
+ * scenario in a run
+ *********************************************/
+struct Mode
+{
+   Mode() : integrator(GAME_EULER), collisions(0) {}
+
+   IntegratorType integrator;
+   uint32_t collisions;        // COLLIDE_ bits
+};
+
+/*********************************************
+ * DESCRIBE
+ * A mode in words, for the summary
+ *********************************************/
+string describe(const Mode & mode)
+{
+   string words = string("the ") + INTEGRATOR_NAMES[mode.integrator] + " integrator";
+   if (mode.collisions & COLLIDE_SWEPT)
+      words += ", swept collisions";
+   if (mode.collisions & COLLIDE_POLYGON)
+      words += ", outline collisions";
+   return words;
+}
+
+/*********************************************
+ * GOLDEN HEADER
+ * The start of a golden file. After it, for
+ * each scenario: its seed and step count as
+ * two uint64_t, then one uint64_t hash per
+ * step. Like the ground files, it is only
+ * read on a machine with the same byte order
+ *********************************************/
+struct GoldenHeader
+{
+   char     magic[8];          // "APOLLORG"
+   uint32_t version;           // GOLDEN_VERSION
+   uint32_t byteOrder;         // GOLDEN_BYTE_ORDER, as written
+   uint64_t numScenarios;
+   uint64_t maxSteps;
+   uint64_t firstSeed;
+   uint32_t integrator;        // the IntegratorType the landers used
+   uint32_t collisions;        // COLLIDE_ bits
+   uint64_t frameHash;         // the pixels of the first scenario's last frame
+};
+
+const char     GOLDEN_MAGIC[8] = { 'A', 'P', 'O', 'L', 'L', 'O', 'R', 'G' };
+const uint32_t GOLDEN_VERSION = 3;
+const uint32_t GOLDEN_BYTE_ORDER = 0x01020304;
+
+/*********************************************
+ * SCENARIO
+ * One lander's flight: which seed it came
+ * from and the hash after every step
+ *********************************************/
+struct Scenario
+{
+   uint64_t seed;
+   vector<uint64_t> hashes;
+};
+
+/*********************************************
+ * DIVERGENCE
+ * Where a scenario first stopped matching.
+ * step is -1 if it never did
+ *********************************************/
+struct Divergence
+{
+   int step;
+   int goldenSteps;            // how far the golden lander flew
+   int steps;                  // how far it flies now
+   LanderState state;          // the lander at that step, now
+};
+
+/*************************************************************************
+ * HASH WORD
+ * Fold 64 bits into a running hash: FNV-1a a word at a time, with the
+ * SplitMix64 finalizer so every bit of the word reaches every bit of
+ * the hash
+ *************************************************************************/
+inline uint64_t hashWord(uint64_t hash, uint64_t word)
+{
+   hash = (hash ^ word) * 0x100000001b3ULL;
+   hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+   return hash ^ (hash >> 31);
+}
+
+inline uint64_t hashDouble(uint64_t hash, double value)
+{
+   uint64_t bits;
+   memcpy(&bits, &value, sizeof(bits));
+   return hashWord(hash, bits);
+}
+
+/*************************************************************************
+ * HASH STATE
+ * Every field of the lander, bit for bit, chained onto the hash of the
+ * step before so once two runs differ they differ from then on
+ *************************************************************************/
+uint64_t hashState(uint64_t hash, const LanderState & state)
+{
+   hash = hashDouble(hash, state.x);
+   hash = hashDouble(hash, state.y);
+   hash = hashDouble(hash, state.dx);
+   hash = hashDouble(hash, state.dy);
+   hash = hashDouble(hash, state.angle);
+   hash = hashDouble(hash, state.thrust);
+   hash = hashWord(hash, (uint64_t)(int64_t)state.fuel);
+   return hashWord(hash, (uint64_t)state.status);
+}
+
+/*********************************************
+ * SCRIPT
+ * Controls made up from the seed: hold some
+ * combination of keys for a while, then pick
+ * another
+ *********************************************/
+struct Script
+{
+   Script(uint64_t seed) : rng(seed, 2), remaining(0)
+   {
+      input.up = input.left = input.right = false;
+   }
+
+   Random rng;
+   LanderInput input;
+   int remaining;              // steps left to hold the input
+};
+
+LanderInput scripted(const LanderState &, void * p)
+{
+   Script & script = *(Script *)p;
+   if (script.remaining == 0)
+   {
+      script.input.up    = script.rng.nextInt(0, 2) == 0;
+      script.input.left  = script.rng.nextInt(0, 5) == 0;
+      script.input.right = script.rng.nextInt(0, 5) == 0;
+      script.remaining   = script.rng.nextInt(1, 30);
+   }
+   script.remaining--;
+   return script.input;
+}
+
+/*************************************************************************
+ * FLY
+ * Run one scenario from its seed: a ground, a lander starting somewhere
+ * near the top with some drift, and a script. Calls back with the state
+ * after every step; stops early if the callback says so
+ *************************************************************************/
+int fly(uint64_t seed, int maxSteps, const Mode & mode,
+        bool (*visit)(int step, const LanderState & state, uint64_t hash, void * p),
+        void * p)
+{
+   Point ptUpperRight(WORLD_WIDTH, WORLD_HEIGHT);
+   Random groundRng(seed, 0);
+   Ground ground(ptUpperRight, groundRng);
+
+   Simulator sim(ground);
+   sim.setIntegrator(mode.integrator);
+   sim.setSweptCollision((mode.collisions & COLLIDE_SWEPT) != 0);
+   sim.setPolygonCollision((mode.collisions & COLLIDE_POLYGON) != 0);
+   LanderState state = sim.start(ptUpperRight);
+   Random startRng(seed, 1);
+   state.x  -= startRng.nextDouble(0.0, WORLD_WIDTH - 200.0);
+   state.dx  = startRng.nextDouble(-3.0, 3.0);
+   state.dy  = startRng.nextDouble(-2.0, 0.0);
+
+   Script script(seed);
+   uint64_t hash = hashWord(0xcbf29ce484222325ULL, seed);
+   int step = 0;
+   while (step < maxSteps && state.status == FLYING)
+   {
+      sim.step(state, scripted(state, &script));
+      hash = hashState(hash, state);
+      if (!visit(step++, state, hash, p))
+         break;
+   }
+   return step;
+}
+
+/*************************************************************************
+ * DRAW FRAME
+ * Fly a scenario and draw where it ended, the way the game draws a
+ * frame, with the software renderer. Returns the hash of the pixels,
+ * and saves them to ppmFile if there is one
+ *************************************************************************/
+bool lastStep(int, const LanderState & state, uint64_t, void * p)
+{
+   *(LanderState *)p = state;
+   return true;
+}
+
+uint64_t drawFrame(uint64_t seed, int maxSteps, const Mode & mode,
+                   const char * ppmFile, ThreadPool & pool)
+{
+   Point ptUpperRight(WORLD_WIDTH, WORLD_HEIGHT);
+   Random groundRng(seed, 0);
+   Ground ground(ptUpperRight, groundRng);
+   LanderState lander;
+   fly(seed, maxSteps, mode, lastStep, &lander);
+
+   DrawBuffer frame;
+   {
+      Point ptLM(lander.x, lander.y);
+      ogstream gout(Point(20.0, WORLD_HEIGHT - 40.0), &frame);
+      ground.draw(gout);
+      gout.drawLanderFlames(ptLM, lander.angle, true /*bottom*/, true /*left*/, true /*right*/);
+      gout.drawLander(ptLM, lander.angle);
+      gout.drawStar(Point(WORLD_WIDTH - 20.0, WORLD_HEIGHT - 20.0), 128);
+      gout << "Fuel: " << lander.fuel << "\n";
+      gout << "Altitude: " << (int)ground.getElevation(ptLM) << "\n";
+   }
+
+   SoftwareRenderer renderer((int)WORLD_WIDTH, (int)WORLD_HEIGHT);
+   renderer.clear();
+   renderer.render(frame, &pool);
+   if (ppmFile != NULL && !renderer.writePPM(ppmFile))
+      fprintf(stderr, "Cannot write %s\n", ppmFile);
+
+   uint64_t hash = hashWord(0xcbf29ce484222325ULL, seed);
+   const uint32_t * pixels = renderer.getPixels();
+   for (int i = 0; i < renderer.getWidth() * renderer.getHeight(); i++)
+      hash = hashWord(hash, pixels[i]);
+   return hash;
+}
+
+/*************************************************************************
+ * RECORD
+ *************************************************************************/
+struct RecordJob
+{
+   vector<Scenario> * pScenarios;
+   int maxSteps;
+   Mode mode;
+};
+
+bool recordStep(int, const LanderState &, uint64_t hash, void * p)
+{
+   ((vector<uint64_t> *)p)->push_back(hash);
+   return true;
+}
+
+void recordScenarios(int begin, int end, int, void * p)
+{
+   RecordJob & job = *(RecordJob *)p;
+   for (int i = begin; i < end; i++)
+   {
+      Scenario & scenario = (*job.pScenarios)[i];
+      fly(scenario.seed, job.maxSteps, job.mode, recordStep, &scenario.hashes);
+   }
+}
+
+int record(const char * fileName, int numScenarios, int maxSteps, uint64_t firstSeed,
+           const Mode & mode, const char * ppmFile, ThreadPool & pool)
+{
+   vector<Scenario> scenarios(numScenarios);
+   for (int i = 0; i < numScenarios; i++)
+      scenarios[i].seed = firstSeed + i;
+
+   RecordJob job;
+   job.pScenarios = &scenarios;
+   job.maxSteps = maxSteps;
+   job.mode = mode;
+   pool.parallelFor(numScenarios, 8, recordScenarios, &job);
+
+   GoldenHeader header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, GOLDEN_MAGIC, sizeof(header.magic));
+   header.version      = GOLDEN_VERSION;
+   header.byteOrder    = GOLDEN_BYTE_ORDER;
+   header.numScenarios = numScenarios;
+   header.maxSteps     = maxSteps;
+   header.firstSeed    = firstSeed;
+   header.integrator   = (uint32_t)mode.integrator;
+   header.collisions   = mode.collisions;
+   header.frameHash    = drawFrame(firstSeed, maxSteps, mode, ppmFile, pool);
+
+   FILE * fout = fopen(fileName, "wb");
+   if (fout == NULL)
+   {
+      fprintf(stderr, "Cannot write %s\n", fileName);
+      return 2;
+   }
+   bool ok = fwrite(&header, sizeof(header), 1, fout) == 1;
+   uint64_t totalSteps = 0;
+   for (int i = 0; ok && i < numScenarios; i++)
+   {
+      uint64_t prefix[2] = { scenarios[i].seed, (uint64_t)scenarios[i].hashes.size() };
+      ok = fwrite(prefix, sizeof(prefix), 1, fout) == 1;
+      if (ok && !scenarios[i].hashes.empty())
+         ok = fwrite(&scenarios[i].hashes[0], sizeof(uint64_t),
+                     scenarios[i].hashes.size(), fout) == scenarios[i].hashes.size();
+      totalSteps += scenarios[i].hashes.size();
+   }
+   ok = (fclose(fout) == 0) && ok;
+   if (!ok)
+   {
+      fprintf(stderr, "Cannot write %s\n", fileName);
+      return 2;
+   }
+
+   printf("recorded %d scenarios, %llu steps with %s\n", numScenarios,
+          (unsigned long long)totalSteps, describe(mode).c_str());
+   return 0;
+}
+
+/*************************************************************************
+ * VERIFY
+ *************************************************************************/
+struct VerifyJob
+{
+   const uint64_t * seeds;       // one per scenario
+   const uint64_t * const * golden; // the hashes of each scenario
+   const uint64_t * goldenSteps;
+   int maxSteps;
+   Mode mode;
+   vector<Divergence> * pResults;
+};
+
+struct Comparison
+{
+   const uint64_t * golden;
+   int goldenSteps;
+   Divergence * pResult;
+};
+
+bool verifyStep(int step, const LanderState & state, uint64_t hash, void * p)
+{
+   Comparison & compare = *(Comparison *)p;
+   if (step < compare.goldenSteps && compare.golden[step] == hash)
+      return true;
+   compare.pResult->step = step;
+   compare.pResult->state = state;
+   return false;
+}
+
+void verifyScenarios(int begin, int end, int, void * p)
+{
+   VerifyJob & job = *(VerifyJob *)p;
+   for (int i = begin; i < end; i++)
+   {
+      Divergence & result = (*job.pResults)[i];
+      result.step = -1;
+      result.goldenSteps = (int)job.goldenSteps[i];
+
+      Comparison compare;
+      compare.golden = job.golden[i];
+      compare.goldenSteps = result.goldenSteps;
+      compare.pResult = &result;
+      result.steps = fly(job.seeds[i], job.maxSteps, job.mode, verifyStep, &compare);
+
+      // the golden lander flew further than this one
+      if (result.step < 0 && result.steps < result.goldenSteps)
+         result.step = result.steps;
+   }
+}
+
+int verify(const char * fileName, int numReport, const char * ppmFile, ThreadPool & pool)
+{
+   MappedFile file;
+   if (!file.open(fileName) || file.size() < sizeof(GoldenHeader))
+   {
+      fprintf(stderr, "Cannot read %s\n", fileName);
+      return 2;
+   }
+   const char * base = (const char *)file.data();
+   const GoldenHeader & header = *(const GoldenHeader *)base;
+   if (memcmp(header.magic, GOLDEN_MAGIC, sizeof(header.magic)) != 0 ||
+       header.version != GOLDEN_VERSION || header.byteOrder != GOLDEN_BYTE_ORDER ||
+       header.numScenarios > (uint64_t)INT32_MAX || header.maxSteps > (uint64_t)INT32_MAX ||
+       header.integrator >= (uint32_t)NUM_INTEGRATORS || (header.collisions & ~COLLIDE_ALL) != 0)
+   {
+      fprintf(stderr, "%s is not a golden file this program can read\n", fileName);
+      return 2;
+   }
+
+   // find where each scenario's hashes start
+   int numScenarios = (int)header.numScenarios;
+   vector<uint64_t> seeds(numScenarios);
+   vector<uint64_t> goldenSteps(numScenarios);
+   vector<const uint64_t *> golden(numScenarios);
+   size_t offset = sizeof(GoldenHeader);
+   for (int i = 0; i < numScenarios; i++)
+   {
+      if (offset + 2 * sizeof(uint64_t) > file.size())
+      {
+         fprintf(stderr, "%s is cut short\n", fileName);
+         return 2;
+      }
+      const uint64_t * prefix = (const uint64_t *)(base + offset);
+      seeds[i] = prefix[0];
+      goldenSteps[i] = prefix[1];
+      golden[i] = prefix + 2;
+      if (goldenSteps[i] > header.maxSteps ||
+          offset + (2 + goldenSteps[i]) * sizeof(uint64_t) > file.size())
+      {
+         fprintf(stderr, "%s is cut short\n", fileName);
+         return 2;
+      }
+      offset += (2 + goldenSteps[i]) * sizeof(uint64_t);
+   }
+
+   vector<Divergence> results(numScenarios);
+   VerifyJob job;
+   job.seeds = &seeds[0];
+   job.golden = &golden[0];
+   job.goldenSteps = &goldenSteps[0];
+   job.maxSteps = (int)header.maxSteps;
+   job.mode.integrator = (IntegratorType)header.integrator;
+   job.mode.collisions = header.collisions;
+   job.pResults = &results;
+   pool.parallelFor(numScenarios, 8, verifyScenarios, &job);
+
+   int numDiverged = 0;
+   for (int i = 0; i < numScenarios; i++)
+   {
+      const Divergence & result = results[i];
+      if (result.step < 0)
+         continue;
+      if (numDiverged++ >= numReport)
+         continue;
+
+      if (result.step == result.steps)
+         printf("scenario %d (seed %llu) ends at step %d, golden flew %d steps\n",
+                i, (unsigned long long)seeds[i], result.step, result.goldenSteps);
+      else
+         printf("scenario %d (seed %llu) diverges at step %d of %d\n"
+                "   now x=%.17g y=%.17g dx=%.17g dy=%.17g angle=%.17g fuel=%d status=%d\n",
+                i, (unsigned long long)seeds[i], result.step, result.goldenSteps,
+                result.state.x, result.state.y, result.state.dx, result.state.dy,
+                result.state.angle, result.state.fuel, (int)result.state.status);
+   }
+
+   if (numDiverged > numReport)
+      printf("... and %d more\n", numDiverged - numReport);
+   printf("%d of %d scenarios match with %s\n", numScenarios - numDiverged,
+          numScenarios, describe(job.mode).c_str());
+
+   bool frameMatches = drawFrame(header.firstSeed, job.maxSteps, job.mode, ppmFile, pool) ==
+                       header.frameHash;
+   printf("the frame drawn from the first scenario %s\n",
+          frameMatches ? "matches" : "does not match");
+   return numDiverged == 0 && frameMatches ? 0 : 1;
+}
+
+/*************************************************************************
+ * HISTORY
+ *************************************************************************/
+struct HistoryJob
+{
+   uint64_t firstSeed;
+   int maxSteps;
+   Mode mode;
+   vector<long> * pResults;    // the first frame that came back wrong, or -1
+};
+
+bool historyStep(int, const LanderState & state, uint64_t, void * p)
+{
+   double speed = sqrt(state.dx * state.dx + state.dy * state.dy);
+   ((vector<gameState> *)p)->push_back(gameState(state, state.y, speed));
+   return true;
+}
+
+// read back every frame still kept, first to last and then last to
+// first. The first one that differs from what was pushed, or -1
+long readBack(gameHistory & history, const vector<gameState> & frames)
+{
+   if (history.empty())
+      return -1;
+   gameState state;
+   if (history.first() > 0 && history.get(history.first() - 1, state))
+      return history.first() - 1;
+   for (int pass = 0; pass < 2; pass++)
+      for (long i = 0; i < history.size(); i++)
+      {
+         long frame = pass == 0 ? history.first() + i : history.last() - i;
+         if (!history.get(frame, state) ||
+             memcmp(&state, &frames[frame], sizeof(state)) != 0)
+            return frame;
+      }
+   return -1;
+}
+
+long checkHistory(uint64_t seed, int maxSteps, const Mode & mode)
+{
+   vector<gameState> frames;
+   fly(seed, maxSteps, mode, historyStep, &frames);
+
+   gameHistory history(HISTORY_FRAMES);
+   for (size_t i = 0; i < frames.size(); i++)
+      history.push(frames[i]);
+   long bad = readBack(history, frames);
+   if (bad >= 0 || history.empty())
+      return bad;
+
+   // go back a third of the way and carry on somewhere else: the
+   // frames that were forgotten, in reverse
+   long back = history.size() / 3;
+   long frame = history.last() - back;
+   gameState state;
+   if (!history.rewind(back, state) ||
+       memcmp(&state, &frames[frame], sizeof(state)) != 0)
+      return frame;
+   for (long i = 0; i < back; i++)
+   {
+      frames[frame + 1 + i] = frames[frames.size() - 1 - i];
+      history.push(frames[frame + 1 + i]);
+   }
+   return readBack(history, frames);
+}
+
+void historyScenarios(int begin, int end, int, void * p)
+{
+   HistoryJob & job = *(HistoryJob *)p;
+   for (int i = begin; i < end; i++)
+      (*job.pResults)[i] = checkHistory(job.firstSeed + i, job.maxSteps, job.mode);
+}
+
+int history(int numScenarios, int maxSteps, uint64_t firstSeed, int numReport,
+            const Mode & mode, ThreadPool & pool)
+{
+   vector<long> results(numScenarios);
+   HistoryJob job;
+   job.firstSeed = firstSeed;
+   job.maxSteps = maxSteps;
+   job.mode = mode;
+   job.pResults = &results;
+   pool.parallelFor(numScenarios, 8, historyScenarios, &job);
+
+   int numWrong = 0;
+   for (int i = 0; i < numScenarios; i++)
+   {
+      if (results[i] < 0)
+         continue;
+      if (numWrong++ < numReport)
+         printf("scenario %d (seed %llu): frame %ld of the history is wrong\n",
+                i, (unsigned long long)(firstSeed + i), results[i]);
+   }
+   if (numWrong > numReport)
+      printf("... and %d more\n", numWrong - numReport);
+   printf("%d of %d histories read back the same\n", numScenarios - numWrong, numScenarios);
+   return numWrong == 0 ? 0 : 1;
+}
+
+/*********************************
+ * MAIN
+ * record, verify, or check the history
+ *********************************/
+int main(int argc, char ** argv)
+{
+   bool isHistory = argc >= 2 && strcmp(argv[1], "history") == 0;
+   if (!isHistory &&
+       (argc < 3 || (strcmp(argv[1], "record") != 0 && strcmp(argv[1], "verify") != 0)))
+   {
+      fprintf(stderr, "usage: %s record FILE [--scenarios N] [--steps N] [--seed N]\n"
+                      "                   [--integrator game|semi|verlet|rk4|rk45] [--swept] [--polygon]\n"
+                      "                   [--frame PPM]\n"
+                      "       %s verify FILE [--report N] [--frame PPM]\n"
+                      "       %s history [--scenarios N] [--steps N] [--seed N] [--report N]\n",
+              argv[0], argv[0], argv[0]);
+      return 2;
+   }
+
+   int numScenarios = DEFAULT_SCENARIOS;
+   int maxSteps = DEFAULT_STEPS;
+   uint64_t firstSeed = DEFAULT_SEED;
+   int numReport = DEFAULT_REPORT;
+   const char * ppmFile = NULL;
+   Mode mode;
+   for (int i = isHistory ? 2 : 3; i < argc; i++)
+   {
+      if (i + 1 < argc && strcmp(argv[i], "--scenarios") == 0)
+         numScenarios = atoi(argv[++i]);
+      else if (i + 1 < argc && strcmp(argv[i], "--steps") == 0)
+         maxSteps = atoi(argv[++i]);
+      else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0)
+         firstSeed = strtoull(argv[++i], NULL, 10);
+      else if (i + 1 < argc && strcmp(argv[i], "--report") == 0)
+         numReport = atoi(argv[++i]);
+      else if (i + 1 < argc && strcmp(argv[i], "--frame") == 0)
+         ppmFile = argv[++i];
+      else if (i + 1 < argc && strcmp(argv[i], "--integrator") == 0)
+      {
+         const char * name = argv[++i];
+         int type = 0;
+         while (type < NUM_INTEGRATORS && strcmp(name, INTEGRATOR_NAMES[type]) != 0)
+            type++;
+         if (type == NUM_INTEGRATORS)
+         {
+            fprintf(stderr, "There is no integrator called %s\n", name);
+            return 2;
+         }
+         mode.integrator = (IntegratorType)type;
+      }
+      else if (strcmp(argv[i], "--swept") == 0)
+         mode.collisions |= COLLIDE_SWEPT;
+      else if (strcmp(argv[i], "--polygon") == 0)
+         mode.collisions |= COLLIDE_POLYGON;
+   }
+   if (numScenarios < 1 || maxSteps < 1)
+   {
+      fprintf(stderr, "There must be at least one scenario and one step\n");
+      return 2;
+   }
+
+   ThreadPool pool;
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   int result = isHistory ?
+      history(numScenarios, maxSteps, firstSeed, numReport, mode, pool) :
+      strcmp(argv[1], "record") == 0 ?
+      record(argv[2], numScenarios, maxSteps, firstSeed, mode, ppmFile, pool) :
+      verify(argv[2], numReport, ppmFile, pool);
+   printf("%.3f seconds on %d threads\n",
+          chrono::duration<double>(chrono::steady_clock::now() - start).count(),
+          pool.size());
+   return result;
+}
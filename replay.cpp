@@ -0,0 +1,305 @@
+/***********************************************************************
+ * Source File:
+ *    Replay : Everything the player did, in a few bytes
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Record the keys on every step as run-length encoded bits, save and
+ *    load them with the ground seed, and play them back.
+ ************************************************************************/
+
+#include "replay.h"  // for the Replay class definition
+#include <cstdio>
+#include <cstring>   // for memcpy() and memcmp()
+#include <cassert>
+#include <climits>   // for INT_MAX
+#include <algorithm> // for std::min()
+
+/*********************************************
+ * REPLAY HEADER
+ * The start of a replay file. The key bits
+ * follow straight after it. Like the ground
+ * files, a machine with the other byte order
+ * refuses the file
+ *********************************************/
+struct ReplayHeader
+{
+   char     magic[8];          // "APOLLORP"
+   uint32_t version;           // REPLAY_VERSION
+   uint32_t byteOrder;         // REPLAY_BYTE_ORDER, as written
+   uint64_t seed;              // the ground seed
+   double   width;             // the size of the world
+   double   height;
+   double   stepsPerSecond;
+   uint64_t numSteps;
+   uint64_t numBits;           // of key data
+};
+
+const char     REPLAY_MAGIC[8] = { 'A', 'P', 'O', 'L', 'L', 'O', 'R', 'P' };
+const uint32_t REPLAY_VERSION = 1;
+const uint32_t REPLAY_BYTE_ORDER = 0x01020304;
+const int      KEY_BITS = 4;   // bits for the keys of one run
+
+/************************************************************************
+ * REPLAY constructor
+ ************************************************************************/
+Replay::Replay() :
+   seed(0), ptUpperRight(0.0, 0.0), stepsPerSecond(30.0), numSteps(0),
+   numBits(0), runKeys(0), runLength(0),
+   readBit(0), playKeys(0), playLeft(0), played(0)
+{
+}
+
+/************************************************************************
+ * START
+ ************************************************************************/
+void Replay::start(uint64_t seed, const Point & ptUpperRight, double stepsPerSecond)
+{
+   assert(stepsPerSecond > 0.0);
+   this->seed = seed;
+   this->ptUpperRight = ptUpperRight;
+   this->stepsPerSecond = stepsPerSecond;
+   numSteps = 0;
+   bits.clear();
+   numBits = 0;
+   runKeys = 0;
+   runLength = 0;
+   rewind();
+}
+
+/************************************************************************
+ * RECORD
+ * Grow the run if the keys have not changed, otherwise write it out
+ * and start a new one
+ ************************************************************************/
+void Replay::record(unsigned int keys)
+{
+   assert(keys < (1u << KEY_BITS));
+   if (runLength > 0 && keys != runKeys)
+      flush();
+   runKeys = keys;
+   runLength++;
+   numSteps++;
+}
+
+/************************************************************************
+ * FLUSH
+ * A run is the keys, then the length as an Elias gamma code: one less
+ * zero than the length has bits, then the length itself
+ ************************************************************************/
+void Replay::flush()
+{
+   if (runLength == 0)
+      return;
+
+   int numLengthBits = 0;
+   while ((uint64_t)runLength >> numLengthBits)
+      numLengthBits++;
+
+   putBits(runKeys, KEY_BITS);
+   putBits(0, numLengthBits - 1);
+   putBits((uint64_t)runLength, numLengthBits);
+   runLength = 0;
+}
+
+/************************************************************************
+ * PUT BITS
+ * The low count bits of value, most significant first
+ ************************************************************************/
+void Replay::putBits(uint64_t value, int count)
+{
+   assert(count >= 0 && count <= 64);
+   for (int i = count - 1; i >= 0; i--)
+   {
+      if (numBits % 8 == 0)
+         bits.push_back(0);
+      if ((value >> i) & 1)
+         bits.back() |= (uint8_t)(0x80 >> (numBits % 8));
+      numBits++;
+   }
+}
+
+/************************************************************************
+ * GET BITS
+ * The next count bits. Past the end reads as zero
+ ************************************************************************/
+uint64_t Replay::getBits(int count)
+{
+   assert(count >= 0 && count <= 64);
+   uint64_t value = 0;
+   for (int i = 0; i < count; i++)
+   {
+      int bit = 0;
+      if (readBit < numBits)
+         bit = (bits[readBit / 8] >> (7 - readBit % 8)) & 1;
+      value = (value << 1) | (uint64_t)bit;
+      readBit++;
+   }
+   return value;
+}
+
+/************************************************************************
+ * REWIND
+ ************************************************************************/
+void Replay::rewind()
+{
+   readBit = 0;
+   playKeys = 0;
+   playLeft = 0;
+   played = 0;
+}
+
+/************************************************************************
+ * NEXT
+ * Read a new run when the last one is used up
+ ************************************************************************/
+bool Replay::next(unsigned int & keys)
+{
+   if (played >= numSteps)
+      return false;
+
+   if (playLeft == 0)
+   {
+      if (readBit + KEY_BITS + 1 > numBits)
+         return false;
+      playKeys = (unsigned int)getBits(KEY_BITS);
+
+      // count the zeros up to the first bit of the length
+      int numZeros = 0;
+      while (readBit < numBits && getBits(1) == 0)
+         numZeros++;
+      if (numZeros > 62 || readBit + numZeros > numBits)
+         return false;
+      playLeft = (long)(((uint64_t)1 << numZeros) | getBits(numZeros));
+   }
+
+   keys = playKeys;
+   playLeft--;
+   played++;
+   return true;
+}
+
+/************************************************************************
+ * SIMULATE
+ * Every recorded step, as fast as it will go. With the simulator set to
+ * fast forward, a run with no keys down is coasted through in one go
+ ************************************************************************/
+int Replay::simulate(Simulator & sim, LanderState & state)
+{
+   rewind();
+   int steps = 0;
+   unsigned int keys;
+   while (next(keys))
+   {
+      if (sim.getFastForward() && state.status == FLYING &&
+          (keys & (REPLAY_UP | REPLAY_LEFT | REPLAY_RIGHT)) == 0)
+      {
+         // the rest of the run goes by as if next() had been called
+         long skipped = sim.coast(state, (int)std::min(playLeft + 1, (long)INT_MAX)) - 1;
+         playLeft -= skipped;
+         played += skipped;
+         steps += (int)skipped;
+      }
+      else
+         sim.step(state, unpack(keys));
+      steps++;
+   }
+   return steps;
+}
+
+/************************************************************************
+ * SAVE
+ * The run that is still growing is written too, without ending it
+ ************************************************************************/
+bool Replay::save(const char * fileName) const
+{
+   assert(fileName != NULL);
+   Replay finished(*this);
+   finished.flush();
+
+   ReplayHeader header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, REPLAY_MAGIC, sizeof(header.magic));
+   header.version        = REPLAY_VERSION;
+   header.byteOrder      = REPLAY_BYTE_ORDER;
+   header.seed           = seed;
+   header.width          = ptUpperRight.getX();
+   header.height         = ptUpperRight.getY();
+   header.stepsPerSecond = stepsPerSecond;
+   header.numSteps       = (uint64_t)numSteps;
+   header.numBits        = finished.numBits;
+
+   FILE * fout = fopen(fileName, "wb");
+   if (fout == NULL)
+      return false;
+   bool ok = fwrite(&header, sizeof(header), 1, fout) == 1;
+   if (ok && !finished.bits.empty())
+      ok = fwrite(&finished.bits[0], 1, finished.bits.size(), fout) == finished.bits.size();
+   return (fclose(fout) == 0) && ok;
+}
+
+/************************************************************************
+ * LOAD
+ * Nothing changes unless the whole file is good
+ ************************************************************************/
+bool Replay::load(const char * fileName)
+{
+   assert(fileName != NULL);
+   FILE * fin = fopen(fileName, "rb");
+   if (fin == NULL)
+      return false;
+
+   ReplayHeader header;
+   bool ok = fread(&header, sizeof(header), 1, fin) == 1 &&
+             memcmp(header.magic, REPLAY_MAGIC, sizeof(header.magic)) == 0 &&
+             header.version == REPLAY_VERSION &&
+             header.byteOrder == REPLAY_BYTE_ORDER &&
+             header.width >= 1.0 && header.height > 0.0 &&
+             header.stepsPerSecond > 0.0 &&
+             header.numBits <= header.numSteps * 135 + KEY_BITS; // a gamma code is < 2x64 bits
+
+   std::vector<uint8_t> data;
+   if (ok)
+   {
+      data.resize((size_t)((header.numBits + 7) / 8));
+      if (!data.empty())
+         ok = fread(&data[0], 1, data.size(), fin) == data.size();
+   }
+   fclose(fin);
+   if (!ok)
+      return false;
+
+   seed = header.seed;
+   ptUpperRight = Point(header.width, header.height);
+   stepsPerSecond = header.stepsPerSecond;
+   numSteps = (long)header.numSteps;
+   bits.swap(data);
+   numBits = header.numBits;
+   runKeys = 0;
+   runLength = 0;
+   rewind();
+   return true;
+}
+
+/************************************************************************
+ * PACK
+ ************************************************************************/
+unsigned int Replay::pack(const LanderInput & input, bool space)
+{
+   return (input.up    ? REPLAY_UP    : 0) |
+          (input.left  ? REPLAY_LEFT  : 0) |
+          (input.right ? REPLAY_RIGHT : 0) |
+          (space       ? REPLAY_SPACE : 0);
+}
+
+/************************************************************************
+ * UNPACK
+ ************************************************************************/
+LanderInput Replay::unpack(unsigned int keys)
+{
+   LanderInput input;
+   input.up    = (keys & REPLAY_UP)    != 0;
+   input.left  = (keys & REPLAY_LEFT)  != 0;
+   input.right = (keys & REPLAY_RIGHT) != 0;
+   return input;
+}
@@ -0,0 +1,95 @@
+/***********************************************************************
+ * Header File:
+ *    Replay : Everything the player did, in a few bytes
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    The simulation is deterministic: the same ground seed and the same
+ *    keys on every step always fly the lander the same way. So a whole
+ *    game can be kept as the seed plus the keys. The keys hardly ever
+ *    change from one step to the next, so they are stored as runs: four
+ *    bits for which keys are down and an Elias gamma code for how many
+ *    steps they stayed that way. Holding a key for a second costs about
+ *    two bytes.
+ *
+ *    A replay can be flown again as fast as the CPU allows with no
+ *    window, or fed step by step to the game to watch it.
+ ************************************************************************/
+
+#pragma once
+
+#include "simulator.h"  // for LanderInput and re-simulating
+#include <vector>
+#include <cstdint>      // for uint8_t and uint64_t
+
+// which bit of the key state each key is
+const unsigned int REPLAY_UP    = 1;
+const unsigned int REPLAY_LEFT  = 2;
+const unsigned int REPLAY_RIGHT = 4;
+const unsigned int REPLAY_SPACE = 8;
+
+/***********************************************************
+ * REPLAY
+ * A recorded game: the seed, the size of the world,
+ * and the keys on every step
+ ***********************************************************/
+class Replay
+{
+public:
+   Replay();
+
+   // forget everything and start recording a new game
+   void start(uint64_t seed, const Point & ptUpperRight, double stepsPerSecond);
+
+   // the keys down during the next step
+   void record(unsigned int keys);
+
+   // write the replay to a file, or read one back. False on failure
+   bool save(const char * fileName) const;
+   bool load(const char * fileName);
+
+   // play back from the first step
+   void rewind();
+
+   // the keys for the next step. False once every step has been played
+   bool next(unsigned int & keys);
+
+   // fly the whole game from the start. Returns the number of steps
+   int simulate(Simulator & sim, LanderState & state);
+
+   uint64_t getSeed()           const { return seed;           }
+   const Point & getUpperRight() const { return ptUpperRight;  }
+   double getStepsPerSecond()   const { return stepsPerSecond; }
+   long getSteps()              const { return numSteps;       }
+   size_t bytes()               const { return bits.size();    }  // of key data
+
+   // convert between the keys and the controls for a step
+   static unsigned int pack(const LanderInput & input, bool space);
+   static LanderInput unpack(unsigned int keys);
+
+private:
+   // the run that is still growing
+   void flush();
+
+   // bits onto the end of the stream, and back off it
+   void putBits(uint64_t value, int count);
+   uint64_t getBits(int count);
+
+   uint64_t seed;             // the ground seed
+   Point ptUpperRight;        // the size of the world
+   double stepsPerSecond;     // how fast it was played
+   long numSteps;
+
+   std::vector<uint8_t> bits; // the runs, most significant bit first
+   uint64_t numBits;          // bits used in the last byte and before
+
+   // recording
+   unsigned int runKeys;      // the keys of the run that is growing
+   long runLength;            // how many steps it has so far
+
+   // playing back
+   uint64_t readBit;          // the next bit to read
+   unsigned int playKeys;     // the keys of the run being played
+   long playLeft;             // steps left in it
+   long played;               // steps played so far
+};
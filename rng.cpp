@@ -0,0 +1,34 @@
+/***********************************************************************
+ * Source File:
+ *    Random : Counter-based random number streams
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Every number is a hash of (seed, stream, index) in the style of
+ *    SplitMix64, so a stream has no hidden state beyond its counter.
+ ************************************************************************/
+
+#include "rng.h"     // for the Random class definition
+#include <atomic>    // to number the threads
+
+const uint64_t Random::GOLDEN;
+
+/******************************************************************
+ * THREAD RANDOM
+ * The calling thread's stream, created the first time it is used
+ ****************************************************************/
+Random & threadRandom()
+{
+   static std::atomic<uint64_t> threads(0);
+   thread_local Random random(0, threads++);
+   return random;
+}
+
+/******************************************************************
+ * SEED RANDOM
+ * Start the calling thread's stream over from a known seed
+ ****************************************************************/
+void seedRandom(uint64_t seed, uint64_t stream)
+{
+   threadRandom() = Random(seed, stream);
+}
@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Header File:
+ *    Random : Counter-based random number streams
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Every number is a hash of (seed, stream, index) in the style of
+ *    SplitMix64, so a stream has no hidden state beyond its counter.
+ *    That makes it cheap to jump to any index, safe to give every
+ *    thread its own stream, and the same seed always gives the same
+ *    numbers no matter which thread asks for them.
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>   // for uint64_t
+#include <cassert>
+
+/***********************************************************
+ * RANDOM
+ * A single stream of random numbers
+ ***********************************************************/
+class Random
+{
+public:
+   // each (seed, stream) pair is an independent sequence
+   Random(uint64_t seed = 0, uint64_t stream = 0) : counter(0)
+   {
+      key = mix(mix(seed) ^ (stream * GOLDEN + GOLDEN));
+   }
+
+   // jump to any position in the stream
+   void     seek(uint64_t index) { counter = index; }
+   uint64_t tell() const         { return counter;  }
+
+   // the number at a given position, without moving
+   uint64_t at(uint64_t index) const { return mix(key + index * GOLDEN); }
+
+   // the next 64 random bits
+   uint64_t next() { return at(counter++); }
+
+   // a double in [0, 1)
+   double nextDouble() { return toDouble(next()); }
+
+   // an integer where min <= num < max
+   int nextInt(int min, int max)
+   {
+      assert(min < max);
+      return min + (int)(next() % (uint64_t)((int64_t)max - min));
+   }
+
+   // a double where min <= num <= max
+   double nextDouble(double min, double max)
+   {
+      assert(min <= max);
+      return min + nextDouble() * (max - min);
+   }
+
+   // fill an array in one go. This loop has no dependence from one
+   // element to the next so the compiler is free to vectorize it
+   void fill(uint64_t * out, int n)
+   {
+      const uint64_t base = key + counter * GOLDEN;
+      for (int i = 0; i < n; i++)
+         out[i] = mix(base + (uint64_t)i * GOLDEN);
+      counter += n;
+   }
+
+   void fill(double * out, int n, double min = 0.0, double max = 1.0)
+   {
+      assert(min <= max);
+      const uint64_t base = key + counter * GOLDEN;
+      const double range = max - min;
+      for (int i = 0; i < n; i++)
+         out[i] = min + toDouble(mix(base + (uint64_t)i * GOLDEN)) * range;
+      counter += n;
+   }
+
+private:
+   static const uint64_t GOLDEN = 0x9e3779b97f4a7c15ULL;  // 2^64 / phi
+
+   // the SplitMix64 finalizer
+   static uint64_t mix(uint64_t z)
+   {
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      return z ^ (z >> 31);
+   }
+
+   // the top 53 bits make a double in [0, 1)
+   static double toDouble(uint64_t bits)
+   {
+      return (double)(bits >> 11) * (1.0 / 9007199254740992.0);
+   }
+
+   uint64_t key;       // the hash of the seed and the stream
+   uint64_t counter;   // where we are in the stream
+};
+
+/******************************************************************
+ * THREAD RANDOM
+ * Every thread has its own stream, used by random(). They all
+ * start from seed 0 with the stream set from the thread's
+ * creation order until seedRandom() is called
+ ****************************************************************/
+Random & threadRandom();
+
+// reset the calling thread's stream
+void seedRandom(uint64_t seed, uint64_t stream = 0);
@@ -0,0 +1,543 @@
+/***********************************************************************
+ * Source File:
+ *    Simulator : The headless lunar lander simulation
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Everything needed to advance a lander through time against a
+ *    ground. There are no OpenGL calls in here so the simulation can
+ *    run as fast as the CPU allows, with or without a window.
+ ************************************************************************/
+
+#include "simulator.h"  // for the Simulator class definition
+#include "physicsCore.h" // for the constants worked out at compile time
+#include <cassert>
+#include <cmath>        // for fabs(), ceil() and sqrt()
+#include <algorithm>    // for std::min() and std::max()
+
+const double CLEARANCE_STEP = 0.25;  // of the way to the ground in one RK45 step
+const int    COAST_LEAF     = 4;     // steps a coast search checks one by one
+
+/*********************************************
+ * ENGINE
+ * The acceleration through a step. The engine
+ * and gravity do not change during it
+ *********************************************/
+struct Engine
+{
+   double ax;
+   double ay;
+};
+
+/************************************************************************
+ * CONSTANT ACCELERATION
+ ************************************************************************/
+static void constantAcceleration(const Motion &, double & ax, double & ay, void * p)
+{
+   const Engine * engine = (const Engine *)p;
+   ax = engine->ax;
+   ay = engine->ay;
+}
+
+/************************************************************************
+ * SIMULATOR constructor
+ ************************************************************************/
+Simulator::Simulator(const Ground & ground, double tTime, IntegratorType type) :
+   ground(ground), tTime(tTime), type(GAME_EULER), hNext(0.0), substeps(0),
+   fastForward(false), sweptCollision(false), polygonCollision(false)
+{
+   assert(tTime > 0.0);
+   setIntegrator(type);
+}
+
+/************************************************************************
+ * SET INTEGRATOR
+ ************************************************************************/
+void Simulator::setIntegrator(IntegratorType type)
+{
+   this->type = type;
+   if (type != GAME_EULER)
+      integrator.setType(type);
+   hNext = 0.0;
+}
+
+/************************************************************************
+ * START
+ * A fresh lander near the top-right of the screen
+ ************************************************************************/
+LanderState Simulator::start(const Point & ptUpperRight) const
+{
+   LanderState state;
+   state.x      = ptUpperRight.getX() - 100.0;
+   state.y      = ptUpperRight.getY() - 80.0;
+   state.dx     = 0.0;
+   state.dy     = 0.0;
+   state.angle  = 0.0;
+   state.thrust = 0.0;
+   state.fuel   = 5000;
+   state.status = FLYING;
+   return state;
+}
+
+/************************************************************************
+ * STEP
+ * Advance the lander one time step
+ ************************************************************************/
+LanderStatus Simulator::step(LanderState & state, const LanderInput & input)
+{
+   // nothing moves once the game is over
+   if (state.status != FLYING)
+      return state.status;
+
+   // the acceleration comes from the engine as it was during the last step
+   double ddx = phys.computeHorizontalComponent(state.angle, state.thrust);
+   double ddy = phys.computeVerticalComponent(state.angle, state.thrust) + GRAVITY;
+
+   // respond to the controls
+   if (state.fuel > 0)
+   {
+      if (input.right)
+      {
+         state.fuel -= FUEL_ROTATE;
+         state.angle -= ROTATE;
+      }
+
+      if (input.left)
+      {
+         state.fuel -= FUEL_ROTATE;
+         state.angle += ROTATE;
+      }
+
+      if (input.up)
+      {
+         state.fuel -= FUEL_THRUST;
+         if (state.fuel < 0)
+            state.fuel = 0;
+         state.thrust = LunarPhysics::engine();
+      }
+      else
+         state.thrust = 0.0;
+   }
+   else
+      state.thrust = 0.0;
+
+   // move the lander
+   Point ptFrom(state.x, state.y);
+   integrate(state, ddx, ddy);
+
+   // did it touch anywhere along the way? Stop it there. Off the
+   // platform a touch is a hit, even one that only rests on the ground
+   double t;
+   if (sweptCollision && sweptContact(ptFrom, state, t))
+   {
+      state.x = ptFrom.getX() + (state.x - ptFrom.getX()) * t;
+      state.y = ptFrom.getY() + (state.y - ptFrom.getY()) * t;
+      bool hit;
+      bool platform;
+      contact(state.x, state.y, state.angle, hit, platform);
+      state.status = outcome(state, hit || !platform, platform);
+      return state.status;
+   }
+
+   // did we hit anything?
+   bool hit;
+   bool platform;
+   contact(state.x, state.y, state.angle, hit, platform);
+   state.status = outcome(state, hit, platform);
+   return state.status;
+}
+
+/************************************************************************
+ * OUTCOME
+ * What touching means. A hit is a crash, and on the platform the
+ * lander lands if slow enough, crashes if fast, and otherwise is
+ * still flying
+ ************************************************************************/
+LanderStatus Simulator::outcome(const LanderState & state, bool hit, bool platform)
+{
+   LanderStatus status = state.status;
+   if (hit)
+      status = CRASHED;
+
+   if (platform)
+   {
+      if (state.dy <= 4 && state.dx <= 2)
+         status = LANDED;
+      else if (getSpeed(state) > 4)
+         status = CRASHED;
+   }
+   return status;
+}
+
+/************************************************************************
+ * SWEPT CONTACT
+ * Where along the step from ptFrom to the lander did it first touch?
+ * The ground is swept with the box around whatever shape is tested.
+ * That is exact for the level box, but the outline only reaches the
+ * corners of its box at some angles, so from where the box touched
+ * walk on half a pixel at a time until the outline does, if it does
+ ************************************************************************/
+bool Simulator::sweptContact(const Point & ptFrom, const LanderState & state, double & t) const
+{
+   double drop = getDrop();
+   int width = (int)ceil(2.0 * getHalfWidth());
+   int column;
+   if (!ground.sweptHit(Point(ptFrom.getX(), ptFrom.getY() - drop),
+                        Point(state.x, state.y - drop), width, t, column))
+      return false;
+   if (!polygonCollision)
+      return true;
+
+   double dx = state.x - ptFrom.getX();
+   double dy = state.y - ptFrom.getY();
+   int n = (int)ceil(2.0 * sqrt(dx * dx + dy * dy) * (1.0 - t));
+   double tFirst = t;
+   for (int i = 0; i <= n; i++)
+   {
+      double tTry = tFirst + (n == 0 ? 0.0 : (1.0 - tFirst) * i / n);
+      bool hit;
+      bool platform;
+      contact(ptFrom.getX() + dx * tTry, ptFrom.getY() + dy * tTry, state.angle, hit, platform);
+      if (hit || platform)
+      {
+         t = tTry;
+         return true;
+      }
+   }
+   return false;
+}
+
+/************************************************************************
+ * INTEGRATE
+ * Move the lander through one step under a steady acceleration
+ ************************************************************************/
+void Simulator::integrate(LanderState & state, double ddx, double ddy)
+{
+   if (type == GAME_EULER)
+   {
+      // compute the new velocity
+      state.dx = phys.computeVelocity(state.dx, ddx, tTime);
+      state.dy = phys.computeVelocity(state.dy, ddy, tTime);
+
+      // use the velocity to update the position
+      state.x = phys.computeDistance(state.x, -state.dx, ddx, tTime);
+      state.y = phys.computeDistance(state.y, state.dy, ddy, tTime);
+      substeps++;
+      return;
+   }
+
+   // dx is how fast the lander goes to the left, and ddx speeds that up
+   Engine engine = { -ddx, ddy };
+   Motion m = { state.x, state.y, -state.dx, state.dy };
+
+   if (type != RK45)
+   {
+      integrator.step(m, tTime, constantAcceleration, &engine);
+      substeps++;
+   }
+   else
+   {
+      // cut the step short where the lander touches, so the checks in
+      // step() see it where it touched and not below the ground
+      double tLeft = tTime;
+      while (tLeft > tTime * 1e-9)
+      {
+         double tMax = std::min(tLeft, maxSubstep(m, tLeft));
+         tLeft -= integrator.adapt(m, tMax, hNext, constantAcceleration, &engine);
+         substeps++;
+
+         bool hit;
+         bool platform;
+         contact(m.x, m.y, state.angle, hit, platform);
+         if (hit || platform)
+            break;
+      }
+   }
+
+   state.x  = m.x;
+   state.y  = m.y;
+   state.dx = -m.vx;
+   state.dy = m.vy;
+}
+
+/************************************************************************
+ * MAX SUBSTEP
+ * Far above the ground the whole step can be taken at once. Close to
+ * it, the steps get small enough to catch the moment of touching
+ ************************************************************************/
+double Simulator::maxSubstep(const Motion & m, double tLeft) const
+{
+   double speed = fabs(m.vx) + fabs(m.vy);
+   if (ground.empty() || speed == 0.0)
+      return tLeft;
+
+   // the columns the lander could be over before the step is done
+   double width = ground.getUpperRight().getX();
+   double reach = getHalfWidth() + fabs(m.vx) * tLeft + 1.0;
+   int xMin = (int)std::max(0.0, m.x - reach);
+   int xMax = (int)std::min(width - 1.0, m.x + reach);
+   if (xMin > xMax)
+      return tLeft;
+
+   double clearance = m.y - getDrop() - ground.maxElevation(xMin, xMax);
+   return std::max(tTime / MAX_SUBSTEPS, CLEARANCE_STEP * clearance / speed);
+}
+
+/************************************************************************
+ * RUN
+ * Advance through a script of controls until the script runs out
+ * or the game is over
+ ************************************************************************/
+int Simulator::run(LanderState & state, const LanderInput * inputs, int numInputs)
+{
+   assert(inputs != NULL || numInputs == 0);
+
+   int i = 0;
+   while (i < numInputs && state.status == FLYING)
+   {
+      const LanderInput & input = inputs[i];
+      if (fastForward && !input.up && !input.left && !input.right)
+      {
+         int end = i + 1;
+         while (end < numInputs && !inputs[end].up && !inputs[end].left && !inputs[end].right)
+            end++;
+         i += coast(state, end - i);
+      }
+      else
+      {
+         step(state, input);
+         i++;
+      }
+   }
+   return i;
+}
+
+/************************************************************************
+ * RUN
+ * Advance by asking a controller for input every step
+ ************************************************************************/
+int Simulator::run(LanderState & state,
+                   LanderInput (*policy)(const LanderState &, void *), void * p,
+                   int maxSteps)
+{
+   assert(policy != NULL);
+
+   int i = 0;
+   while (i < maxSteps && state.status == FLYING)
+   {
+      step(state, policy(state, p));
+      i++;
+   }
+   return i;
+}
+
+/************************************************************************
+ * COAST
+ * Jump to the step before the first one that could touch, then let
+ * step() decide what touching means. If it was only a near miss, keep
+ * coasting from there
+ ************************************************************************/
+int Simulator::coast(LanderState & state, int maxSteps)
+{
+   assert(maxSteps >= 0);
+   LanderInput none = { false, false, false };
+   int steps = 0;
+
+   // the first step still has the engine as it was the step before
+   if (steps < maxSteps && state.status == FLYING && state.thrust != 0.0)
+   {
+      step(state, none);
+      steps++;
+   }
+
+   while (steps < maxSteps && state.status == FLYING)
+   {
+      int left = maxSteps - steps;
+      int k = 0;
+
+      // look ahead in windows that double, so the search takes about
+      // log(steps) looks at the ground however long the coast is
+      long length = 1;
+      for (int a = 1; a <= left && k == 0; length *= 2)
+      {
+         int b = (int)std::min((long)left, a + length - 1);
+         k = firstTouch(state, a, b);
+         a = b + 1;
+      }
+
+      if (k == 0)
+      {
+         state = ballistic(state, left);
+         steps = maxSteps;
+      }
+      else
+      {
+         if (k > 1)
+            state = ballistic(state, k - 1);
+         step(state, none);
+         steps += k;
+      }
+   }
+   return steps;
+}
+
+/************************************************************************
+ * BALLISTIC
+ * Gravity alone, k steps on, as each integrator would get there:
+ *    x(k) = x - k dx t
+ *    y(k) = y + k dy t + g t^2 c(k)
+ * where c(k) sums the pull of gravity over the steps. The game scheme
+ * counts it as (k^2 + 2k) / 2, semi-implicit Euler as (k^2 + k) / 2,
+ * and the exact ones as k^2 / 2
+ ************************************************************************/
+LanderState Simulator::ballistic(const LanderState & state, int k) const
+{
+   double steps = (double)k;
+   double pull;
+   switch (type)
+   {
+      case GAME_EULER:
+         pull = (steps * steps + 2.0 * steps) / 2.0;
+         break;
+      case SEMI_IMPLICIT_EULER:
+         pull = (steps * steps + steps) / 2.0;
+         break;
+      default:
+         pull = steps * steps / 2.0;
+         break;
+   }
+
+   LanderState after = state;
+   after.x = state.x - steps * state.dx * tTime;
+   after.y = state.y + steps * state.dy * tTime + GRAVITY * tTime * tTime * pull;
+   after.dy = state.dy + steps * GRAVITY * tTime;
+   after.thrust = 0.0;
+   return after;
+}
+
+/************************************************************************
+ * MAY TOUCH
+ * Over steps [a, b] the lander sweeps from x(a) to x(b), and being on
+ * an arc it is lowest at one end or the other. If even then it is
+ * more than a pixel above the highest ground it could be over, it
+ * cannot have hit the ground or be on the platform. Off the edge of the
+ * world there is no ground to hit and the platform is far away, so a
+ * lander that drifts off the side coasts on in one jump
+ ************************************************************************/
+bool Simulator::mayTouch(const LanderState & state, int a, int b) const
+{
+   if (ground.empty())
+      return false;
+
+   LanderState first = ballistic(state, a);
+   LanderState last = ballistic(state, b);
+
+   // the columns it could be over. The footprint rounds toward zero, so
+   // a lander reaching to just short of column 0 still tests column 0
+   double width = ground.getUpperRight().getX();
+   double xLow = std::min(first.x, last.x) - getHalfWidth();
+   double xHigh = std::max(first.x, last.x) + getHalfWidth();
+   if (xHigh <= -1.0 || xLow >= width)
+      return false;
+
+   int xMin = (int)std::max(0.0, xLow);
+   int xMax = (int)std::min(width - 1.0, xHigh);
+   return std::min(first.y, last.y) - getDrop() <= ground.maxElevation(xMin, xMax) + 1.0;
+}
+
+/************************************************************************
+ * TOUCHES
+ * Does the lander touch anything at the end of step k of a coast?
+ ************************************************************************/
+bool Simulator::touches(const LanderState & state, int k) const
+{
+   // RK45 and swept collisions find touches part way through a step.
+   // Any step that could touch has to be stepped
+   if (type == RK45 || sweptCollision)
+      return mayTouch(state, k - 1, k);
+
+   LanderState after = ballistic(state, k);
+   bool hit;
+   bool platform;
+   contact(after.x, after.y, after.angle, hit, platform);
+   return hit || platform;
+}
+
+/************************************************************************
+ * CONTACT
+ * Is the lander in the ground, or on the platform? As a level box, or
+ * as its outline at its angle
+ ************************************************************************/
+void Simulator::contact(double x, double y, double angle, bool & hit, bool & platform) const
+{
+   Point ptLM(x, y);
+   if (polygonCollision)
+   {
+      // well clear of the ground at any angle, so no need to turn it
+      hit = platform = false;
+      double width = ground.getUpperRight().getX();
+      double reach = LanderShape::getRadius();
+      if (ground.empty() || x + reach < 0.0 || x - reach >= width)
+         return;
+      int xMin = std::max(0, (int)(x - reach));
+      int xMax = std::min((int)width - 1, (int)(x + reach));
+      if (y - getDrop() > ground.maxElevation(xMin, xMax) + 1.0)
+         return;
+
+      LanderShape shape(ptLM, angle);
+      hit = ground.hitGround(shape);
+      platform = !hit && ground.onPlatform(shape);
+   }
+   else
+   {
+      hit = ground.hitGround(ptLM, LANDER_WIDTH);
+      platform = ground.onPlatform(ptLM, LANDER_WIDTH);
+   }
+}
+
+/************************************************************************
+ * GET HALF WIDTH and GET DROP
+ * How far the lander reaches to each side of its position, and below
+ * it. Turning the outline can swing it lower than the feet
+ ************************************************************************/
+double Simulator::getHalfWidth() const
+{
+   return polygonCollision ? LanderShape::getRadius() : LANDER_WIDTH / 2.0;
+}
+
+double Simulator::getDrop() const
+{
+   return polygonCollision ? std::max(0.0, LanderShape::getRadius() - LANDER_PIVOT_Y) : 0.0;
+}
+
+/************************************************************************
+ * FIRST TOUCH
+ * Halve the range until it is small enough to check step by step,
+ * skipping every half that cannot touch
+ ************************************************************************/
+int Simulator::firstTouch(const LanderState & state, int a, int b) const
+{
+   if (!mayTouch(state, type == RK45 || sweptCollision ? a - 1 : a, b))
+      return 0;
+
+   if (b - a < COAST_LEAF)
+   {
+      for (int k = a; k <= b; k++)
+         if (touches(state, k))
+            return k;
+      return 0;
+   }
+
+   int middle = a + (b - a) / 2;
+   int k = firstTouch(state, a, middle);
+   return k != 0 ? k : firstTouch(state, middle + 1, b);
+}
+
+/************************************************************************
+ * GET SPEED
+ * The total velocity of the lander
+ ************************************************************************/
+double Simulator::getSpeed(const LanderState & state)
+{
+   return phys.computeTotalComponent(state.dx, state.dy);
+}
@@ -0,0 +1,177 @@
+/***********************************************************************
+ * Header File:
+ *    Simulator : The headless lunar lander simulation
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Everything needed to advance a lander through time against a
+ *    ground. There are no OpenGL calls in here so the simulation can
+ *    run as fast as the CPU allows, with or without a window.
+ ************************************************************************/
+
+#pragma once
+
+#include "physics.h"  // for the compute functions
+#include "ground.h"   // for hitGround() and onPlatform()
+#include "integrator.h" // for the ways to move the lander
+
+constexpr double GRAVITY  = -1.625;     // the gravity on the moon (m/s^2)
+constexpr double THRUST   = 45000.000;  // the thrust of the LM (N)
+constexpr double WEIGHT   = 15103.000;  // the weight of the LM (kg)
+constexpr double ROTATE   = 0.06;       // radians turned per step
+const int    LANDER_WIDTH = 20;         // width of the landing gear
+const int    FUEL_ROTATE  = 1;          // fuel used to turn for a step
+const int    FUEL_THRUST  = 10;         // fuel used by the main engine
+const int    MAX_SUBSTEPS = 64;         // the most RK45 cuts a step into
+
+/*********************************************
+ * LANDER STATUS
+ * Where the lander is in its life
+ *********************************************/
+enum LanderStatus
+{
+   FLYING,                 // still in the air
+   LANDED,                 // safely on the platform
+   CRASHED                 // hit the ground or the platform too hard
+};
+
+/*********************************************
+ * LANDER STATE
+ * Everything that changes about a single lander
+ *********************************************/
+struct LanderState
+{
+   double x;               // horizontal position
+   double y;               // vertical position
+   double dx;              // horizontal velocity
+   double dy;              // vertical velocity
+   double angle;           // the angle the LM is pointing (radians)
+   double thrust;          // acceleration from the main engine last step
+   int    fuel;            // fuel remaining
+   LanderStatus status;    // flying, landed, or crashed
+};
+
+/*********************************************
+ * LANDER INPUT
+ * The controls for a single step
+ *********************************************/
+struct LanderInput
+{
+   bool up;                // main engine
+   bool left;              // rotate counter-clockwise
+   bool right;             // rotate clockwise
+};
+
+/***********************************************************
+ * SIMULATOR
+ * Steps a lander against a ground with no drawing
+ ***********************************************************/
+class Simulator
+{
+public:
+   // the simulator works on a ground that somebody else owns
+   Simulator(const Ground & ground, double tTime = 0.1,
+             IntegratorType type = GAME_EULER);
+
+   // the state of a lander at the top of the screen, ready to fly
+   LanderState start(const Point & ptUpperRight) const;
+
+   // advance one step using the given controls
+   LanderStatus step(LanderState & state, const LanderInput & input);
+
+   // advance through a script of controls. Returns the steps taken
+   int run(LanderState & state, const LanderInput * inputs, int numInputs);
+
+   // advance using a controller, up to maxSteps. Returns the steps taken
+   int run(LanderState & state,
+           LanderInput (*policy)(const LanderState &, void *), void * p,
+           int maxSteps);
+
+   // fly with no controls for up to maxSteps, or until the lander
+   // touches something. The arc is worked out in closed form and the
+   // ground index finds the first step that could touch, so a long
+   // coast costs about as much as a few steps. The result matches
+   // stepping to within rounding, except that RK45 may catch the touch
+   // at a slightly different point in the last step. Returns the steps
+   // taken
+   int coast(LanderState & state, int maxSteps);
+
+   // let run() and Replay::simulate() coast through the stretches where
+   // no key is down
+   bool getFastForward() const { return fastForward; }
+   void setFastForward(bool fastForward) { this->fastForward = fastForward; }
+
+   // test the whole path of each step against the ground, not just
+   // where the lander ends up, so it cannot pass through a thin ridge.
+   // A lander that touches stops where it touched. With polygon
+   // collisions on, the outline is swept, not the level box
+   bool getSweptCollision() const { return sweptCollision; }
+   void setSweptCollision(bool sweptCollision) { this->sweptCollision = sweptCollision; }
+
+   // test the lander's outline, turned to its angle, against the ground
+   // instead of a level box LANDER_WIDTH wide. A tilted lander can
+   // catch a leg or a thruster, and only lands with both feet down
+   bool getPolygonCollision() const { return polygonCollision; }
+   void setPolygonCollision(bool polygonCollision) { this->polygonCollision = polygonCollision; }
+
+   // how fast is the lander going?
+   double getSpeed(const LanderState & state);
+
+   // how long is one step?
+   double getTimeStep() const { return tTime; }
+
+   // how the lander is moved through a step. GAME_EULER is the default
+   // and the only one that flies recorded games the way they were played.
+   // RK45 cuts a step into smaller ones as the lander nears the ground
+   IntegratorType getIntegrator() const { return type; }
+   void setIntegrator(IntegratorType type);
+
+   // the steps the integrator has actually taken, counting RK45's cuts
+   long getSubsteps() const { return substeps; }
+
+private:
+   // move the lander through a step with the chosen integrator
+   void integrate(LanderState & state, double ddx, double ddy);
+
+   // the lander k steps into a coast, thrust already off
+   LanderState ballistic(const LanderState & state, int k) const;
+
+   // could the lander touch anything in steps [a, b] of a coast?
+   bool mayTouch(const LanderState & state, int a, int b) const;
+
+   // does it, at step k?
+   bool touches(const LanderState & state, int k) const;
+
+   // the first step in [a, b] where it touches, or zero
+   int firstTouch(const LanderState & state, int a, int b) const;
+
+   // what touching means for the lander: landed, crashed, or still flying
+   LanderStatus outcome(const LanderState & state, bool hit, bool platform);
+
+   // the first touch on the way from ptFrom to where the lander is now,
+   // as a fraction of the way there
+   bool sweptContact(const Point & ptFrom, const LanderState & state, double & t) const;
+
+   // is the lander at (x, y) and angle in the ground or on the platform?
+   void contact(double x, double y, double angle, bool & hit, bool & platform) const;
+
+   // how far the shape being tested reaches out from the lander's
+   // position, and down below it
+   double getHalfWidth() const;
+   double getDrop() const;
+
+   // the longest RK45 step that keeps the lander from closing more than
+   // part of its distance to the ground
+   double maxSubstep(const Motion & m, double tLeft) const;
+
+   const Ground & ground;  // what we are trying to land on
+   physics phys;           // the kinematics equations
+   double tTime;           // time per step
+   IntegratorType type;    // how to move the lander
+   Integrator integrator;  // all but GAME_EULER
+   double hNext;           // the RK45 step to try next
+   long substeps;
+   bool fastForward;       // coast through steps with no controls
+   bool sweptCollision;    // test the path, not just the end of it
+   bool polygonCollision;  // test the outline, not a box
+};
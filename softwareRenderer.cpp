@@ -0,0 +1,463 @@
+/***********************************************************************
+ * Source File:
+ *    Software Renderer : Draw a frame without OpenGL
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Rasterize a recorded DrawBuffer into an RGBA framebuffer in memory.
+ *    Every tile walks the whole buffer in order and only touches its own
+ *    pixels, so tiles never need to be synchronized and the result is
+ *    the same no matter how many threads draw it.
+ ************************************************************************/
+
+#include "softwareRenderer.h"  // for the SoftwareRenderer class definition
+#include <cassert>
+#include <cmath>               // for floor() and ceil()
+#include <cstdio>              // for fopen()
+#include <cstring>             // for memcpy()
+#include <algorithm>           // for std::min() and std::max()
+
+// pick the instructions for filling spans
+#if defined(__SSE2__) || defined(_M_X64)
+#define SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SOFTWARE_RENDERER_NEON
+#include <arm_neon.h>
+#endif
+
+const int SoftwareRenderer::TILE;
+
+const int FONT_FIRST    = 32;   // the font starts at the space
+const int FONT_LAST     = 126;  //    and ends at the tilde
+const int FONT_WIDTH    = 8;
+const int FONT_HEIGHT   = 14;
+const int FONT_BASELINE = 3;    // rows below the baseline
+
+/******************************************************************
+ * FONT
+ * The classic X11 8x13 "fixed" font, one byte per row, top row
+ * first, leftmost pixel in the high bit
+ ****************************************************************/
+static const unsigned char font[FONT_LAST - FONT_FIRST + 1][FONT_HEIGHT] =
+{
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },  // space
+   { 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00 },  // !
+   { 0x00, 0x00, 0x24, 0x24, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },  // "
+   { 0x00, 0x00, 0x00, 0x24, 0x24, 0x7e, 0x24, 0x7e, 0x24, 0x24, 0x00, 0x00, 0x00, 0x00 },  // #
+   { 0x00, 0x00, 0x10, 0x3c, 0x50, 0x50, 0x38, 0x14, 0x14, 0x78, 0x10, 0x00, 0x00, 0x00 },  // $
+   { 0x00, 0x00, 0x22, 0x52, 0x24, 0x08, 0x08, 0x10, 0x24, 0x2a, 0x44, 0x00, 0x00, 0x00 },  // %
+   { 0x00, 0x00, 0x00, 0x00, 0x30, 0x48, 0x48, 0x30, 0x4a, 0x44, 0x3a, 0x00, 0x00, 0x00 },  // &
+   { 0x00, 0x00, 0x38, 0x30, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },  // '
+   { 0x00, 0x00, 0x04, 0x08, 0x08, 0x10, 0x10, 0x10, 0x08, 0x08, 0x04, 0x00, 0x00, 0x00 },  // (
+   { 0x00, 0x00, 0x20, 0x10, 0x10, 0x08, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00, 0x00 },  // )
+   { 0x00, 0x00, 0x00, 0x00, 0x24, 0x18, 0x7e, 0x18, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 },  // *
+   { 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x7c, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00 },  // +
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x30, 0x40, 0x00, 0x00 },  // ,
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },  // -
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00 },  // .
+   { 0x00, 0x00, 0x02, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x80, 0x00, 0x00, 0x00 },  // /
+   { 0x00, 0x00, 0x18, 0x24, 0x42, 0x42, 0x42, 0x42, 0x42, 0x24, 0x18, 0x00, 0x00, 0x00 },  // 0
+   { 0x00, 0x00, 0x10, 0x30, 0x50, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },  // 1
+   { 0x00, 0x00, 0x3c, 0x42, 0x42, 0x02, 0x04, 0x18, 0x20, 0x40, 0x7e, 0x00, 0x00, 0x00 },  // 2
+   { 0x00, 0x00, 0x7e, 0x02, 0x04, 0x08, 0x1c, 0x02, 0x02, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // 3
+   { 0x00, 0x00, 0x04, 0x0c, 0x14, 0x24, 0x44, 0x44, 0x7e, 0x04, 0x04, 0x00, 0x00, 0x00 },  // 4
+   { 0x00, 0x00, 0x7e, 0x40, 0x40, 0x5c, 0x62, 0x02, 0x02, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // 5
+   { 0x00, 0x00, 0x1c, 0x20, 0x40, 0x40, 0x5c, 0x62, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // 6
+   { 0x00, 0x00, 0x7e, 0x02, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x00, 0x00, 0x00 },  // 7
+   { 0x00, 0x00, 0x3c, 0x42, 0x42, 0x42, 0x3c, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // 8
+   { 0x00, 0x00, 0x3c, 0x42, 0x42, 0x46, 0x3a, 0x02, 0x02, 0x04, 0x38, 0x00, 0x00, 0x00 },  // 9
+   { 0x00, 0x00, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00 },  // :
+   { 0x00, 0x00, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00, 0x38, 0x30, 0x40, 0x00, 0x00 },  // ;
+   { 0x00, 0x00, 0x02, 0x04, 0x08, 0x10, 0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00, 0x00 },  // <
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x00, 0x00, 0x00 },  // =
+   { 0x00, 0x00, 0x40, 0x20, 0x10, 0x08, 0x04, 0x08, 0x10, 0x20, 0x40, 0x00, 0x00, 0x00 },  // >
+   { 0x00, 0x00, 0x3c, 0x42, 0x42, 0x02, 0x04, 0x08, 0x08, 0x00, 0x08, 0x00, 0x00, 0x00 },  // ?
+   { 0x00, 0x00, 0x3c, 0x42, 0x42, 0x4e, 0x52, 0x56, 0x4a, 0x40, 0x3c, 0x00, 0x00, 0x00 },  // @
+   { 0x00, 0x00, 0x18, 0x24, 0x42, 0x42, 0x42, 0x7e, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },  // A
+   { 0x00, 0x00, 0xfc, 0x42, 0x42, 0x42, 0x7c, 0x42, 0x42, 0x42, 0xfc, 0x00, 0x00, 0x00 },  // B
+   { 0x00, 0x00, 0x3c, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // C
+   { 0x00, 0x00, 0xfc, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0xfc, 0x00, 0x00, 0x00 },  // D
+   { 0x00, 0x00, 0x7e, 0x40, 0x40, 0x40, 0x78, 0x40, 0x40, 0x40, 0x7e, 0x00, 0x00, 0x00 },  // E
+   { 0x00, 0x00, 0x7e, 0x40, 0x40, 0x40, 0x78, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 },  // F
+   { 0x00, 0x00, 0x3c, 0x42, 0x40, 0x40, 0x40, 0x4e, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00 },  // G
+   { 0x00, 0x00, 0x42, 0x42, 0x42, 0x42, 0x7e, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },  // H
+   { 0x00, 0x00, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },  // I
+   { 0x00, 0x00, 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00 },  // J
+   { 0x00, 0x00, 0x42, 0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x42, 0x00, 0x00, 0x00 },  // K
+   { 0x00, 0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7e, 0x00, 0x00, 0x00 },  // L
+   { 0x00, 0x00, 0x82, 0x82, 0xc6, 0xaa, 0x92, 0x92, 0x82, 0x82, 0x82, 0x00, 0x00, 0x00 },  // M
+   { 0x00, 0x00, 0x42, 0x42, 0x62, 0x52, 0x4a, 0x46, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },  // N
+   { 0x00, 0x00, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // O
+   { 0x00, 0x00, 0x7c, 0x42, 0x42, 0x42, 0x7c, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 },  // P
+   { 0x00, 0x00, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x42, 0x52, 0x4a, 0x3c, 0x02, 0x00, 0x00 },  // Q
+   { 0x00, 0x00, 0x7c, 0x42, 0x42, 0x42, 0x7c, 0x50, 0x48, 0x44, 0x42, 0x00, 0x00, 0x00 },  // R
+   { 0x00, 0x00, 0x3c, 0x42, 0x40, 0x40, 0x3c, 0x02, 0x02, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // S
+   { 0x00, 0x00, 0xfe, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 },  // T
+   { 0x00, 0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // U
+   { 0x00, 0x00, 0x82, 0x82, 0x44, 0x44, 0x44, 0x28, 0x28, 0x28, 0x10, 0x00, 0x00, 0x00 },  // V
+   { 0x00, 0x00, 0x82, 0x82, 0x82, 0x82, 0x92, 0x92, 0x92, 0xaa, 0x44, 0x00, 0x00, 0x00 },  // W
+   { 0x00, 0x00, 0x82, 0x82, 0x44, 0x28, 0x10, 0x28, 0x44, 0x82, 0x82, 0x00, 0x00, 0x00 },  // X
+   { 0x00, 0x00, 0x82, 0x82, 0x44, 0x28, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 },  // Y
+   { 0x00, 0x00, 0x7e, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x40, 0x7e, 0x00, 0x00, 0x00 },  // Z
+   { 0x00, 0x00, 0x3c, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x00, 0x00, 0x00 },  // [
+   { 0x00, 0x00, 0x80, 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x02, 0x00, 0x00, 0x00 },  // backslash
+   { 0x00, 0x00, 0x78, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x78, 0x00, 0x00, 0x00 },  // ]
+   { 0x00, 0x00, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },  // ^
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0x00, 0x00 },  // _
+   { 0x00, 0x00, 0x38, 0x18, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },  // `
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x02, 0x3e, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00 },  // a
+   { 0x00, 0x00, 0x40, 0x40, 0x40, 0x5c, 0x62, 0x42, 0x42, 0x62, 0x5c, 0x00, 0x00, 0x00 },  // b
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x40, 0x40, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // c
+   { 0x00, 0x00, 0x02, 0x02, 0x02, 0x3a, 0x46, 0x42, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00 },  // d
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x7e, 0x40, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // e
+   { 0x00, 0x00, 0x1c, 0x22, 0x20, 0x20, 0x7c, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00 },  // f
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x3a, 0x44, 0x44, 0x38, 0x40, 0x3c, 0x42, 0x3c, 0x00 },  // g
+   { 0x00, 0x00, 0x40, 0x40, 0x40, 0x5c, 0x62, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },  // h
+   { 0x00, 0x00, 0x00, 0x10, 0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },  // i
+   { 0x00, 0x00, 0x00, 0x04, 0x00, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x44, 0x44, 0x38, 0x00 },  // j
+   { 0x00, 0x00, 0x40, 0x40, 0x40, 0x44, 0x48, 0x70, 0x48, 0x44, 0x42, 0x00, 0x00, 0x00 },  // k
+   { 0x00, 0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },  // l
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0xec, 0x92, 0x92, 0x92, 0x92, 0x82, 0x00, 0x00, 0x00 },  // m
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x5c, 0x62, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },  // n
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // o
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x5c, 0x62, 0x42, 0x62, 0x5c, 0x40, 0x40, 0x40, 0x00 },  // p
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x3a, 0x46, 0x42, 0x46, 0x3a, 0x02, 0x02, 0x02, 0x00 },  // q
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x5c, 0x22, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00 },  // r
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x30, 0x0c, 0x42, 0x3c, 0x00, 0x00, 0x00 },  // s
+   { 0x00, 0x00, 0x00, 0x20, 0x20, 0x7c, 0x20, 0x20, 0x20, 0x22, 0x1c, 0x00, 0x00, 0x00 },  // t
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3a, 0x00, 0x00, 0x00 },  // u
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x28, 0x28, 0x10, 0x00, 0x00, 0x00 },  // v
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x82, 0x82, 0x92, 0x92, 0xaa, 0x44, 0x00, 0x00, 0x00 },  // w
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x00, 0x00, 0x00 },  // x
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x42, 0x42, 0x46, 0x3a, 0x02, 0x42, 0x3c, 0x00 },  // y
+   { 0x00, 0x00, 0x00, 0x00, 0x00, 0x7e, 0x04, 0x08, 0x10, 0x20, 0x7e, 0x00, 0x00, 0x00 },  // z
+   { 0x00, 0x00, 0x0e, 0x10, 0x10, 0x08, 0x30, 0x08, 0x10, 0x10, 0x0e, 0x00, 0x00, 0x00 },  // {
+   { 0x00, 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 },  // |
+   { 0x00, 0x00, 0x70, 0x08, 0x08, 0x10, 0x0c, 0x10, 0x08, 0x08, 0x70, 0x00, 0x00, 0x00 },  // }
+   { 0x00, 0x00, 0x24, 0x54, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }   // ~
+};
+
+/******************************************************************
+ * FILL SPAN
+ * Set count pixels in a row to the same color, four at a time
+ ****************************************************************/
+static inline void fillSpan(uint32_t * pixel, int count, uint32_t color)
+{
+   int i = 0;
+#if defined(SOFTWARE_RENDERER_SSE2)
+   const __m128i value = _mm_set1_epi32((int)color);
+   for (; i + 4 <= count; i += 4)
+      _mm_storeu_si128((__m128i *)(pixel + i), value);
+#elif defined(SOFTWARE_RENDERER_NEON)
+   const uint32x4_t value = vdupq_n_u32(color);
+   for (; i + 4 <= count; i += 4)
+      vst1q_u32(pixel + i, value);
+#endif
+   for (; i < count; i++)
+      pixel[i] = color;
+}
+
+/************************************************************************
+ * SOFTWARE RENDERER constructor
+ ************************************************************************/
+SoftwareRenderer::SoftwareRenderer(int width, int height) :
+   width(width), height(height),
+   tilesAcross((width + TILE - 1) / TILE),
+   tilesDown((height + TILE - 1) / TILE),
+   pixels((size_t)width * height)
+{
+   assert(width > 0 && height > 0);
+   clear();
+}
+
+/************************************************************************
+ * PACK
+ * R, G, B, A in memory order, whatever the byte order of the machine
+ ************************************************************************/
+uint32_t SoftwareRenderer::pack(double red, double green, double blue)
+{
+   unsigned char rgba[4];
+   rgba[0] = (unsigned char)(red   <= 0.0 ? 0 : red   >= 1.0 ? 255 : red   * 255.0 + 0.5);
+   rgba[1] = (unsigned char)(green <= 0.0 ? 0 : green >= 1.0 ? 255 : green * 255.0 + 0.5);
+   rgba[2] = (unsigned char)(blue  <= 0.0 ? 0 : blue  >= 1.0 ? 255 : blue  * 255.0 + 0.5);
+   rgba[3] = 255;
+
+   uint32_t color;
+   memcpy(&color, rgba, sizeof(color));
+   return color;
+}
+
+/************************************************************************
+ * CLEAR
+ ************************************************************************/
+void SoftwareRenderer::clear(double red, double green, double blue)
+{
+   fillSpan(&pixels[0], (int)pixels.size(), pack(red, green, blue));
+}
+
+/************************************************************************
+ * GET PIXEL
+ ************************************************************************/
+uint32_t SoftwareRenderer::getPixel(int x, int y) const
+{
+   assert(0 <= x && x < width);
+   assert(0 <= y && y < height);
+   return pixels[(size_t)(height - 1 - y) * width + x];
+}
+
+/*********************************************
+ * RENDER JOB
+ * What the tile workers need
+ *********************************************/
+struct RenderJob
+{
+   SoftwareRenderer * pRenderer;
+   const DrawBuffer * pBuffer;
+};
+
+/************************************************************************
+ * RENDER TILES
+ * The body of the parallel loop: draw tiles [begin, end)
+ ************************************************************************/
+void SoftwareRenderer::renderTiles(int begin, int end, int, void * p)
+{
+   const RenderJob & job = *(const RenderJob *)p;
+   for (int tile = begin; tile < end; tile++)
+      job.pRenderer->renderTile(*job.pBuffer, tile);
+}
+
+/************************************************************************
+ * RENDER
+ ************************************************************************/
+void SoftwareRenderer::render(const DrawBuffer & buffer, ThreadPool * pPool)
+{
+   int numTiles = tilesAcross * tilesDown;
+   RenderJob job;
+   job.pRenderer = this;
+   job.pBuffer = &buffer;
+
+   if (pPool != NULL)
+      pPool->parallelFor(numTiles, 1, renderTiles, &job);
+   else
+      renderTiles(0, numTiles, 0, &job);
+}
+
+/************************************************************************
+ * RENDER TILE
+ * Draw everything in the buffer that lands on one tile. The color of
+ * a primitive is the color of its last vertex, as with GL_FLAT
+ ************************************************************************/
+void SoftwareRenderer::renderTile(const DrawBuffer & buffer, int tile)
+{
+   Clip clip;
+   clip.xMin = (tile % tilesAcross) * TILE;
+   clip.yMin = (tile / tilesAcross) * TILE;
+   clip.xMax = (clip.xMin + TILE < width  ? clip.xMin + TILE : width)  - 1;
+   clip.yMax = (clip.yMin + TILE < height ? clip.yMin + TILE : height) - 1;
+
+   const std::vector<DrawBuffer::Batch> & batches = buffer.getBatches();
+   const float * vertices = buffer.getVertices().empty() ? NULL : &buffer.getVertices()[0];
+   const float * colors   = buffer.getColors().empty()   ? NULL : &buffer.getColors()[0];
+
+   for (size_t b = 0; b < batches.size(); b++)
+   {
+      const DrawBuffer::Batch & batch = batches[b];
+      int stride = (batch.type == DRAW_POINTS ? 1 : batch.type == DRAW_LINES ? 2 : 3);
+
+      for (int i = batch.first; i + stride <= batch.first + batch.count; i += stride)
+      {
+         const float * v = vertices + 2 * i;
+         const float * c = colors + 3 * (i + stride - 1);
+         uint32_t color = pack(c[0], c[1], c[2]);
+
+         if (stride == 1)
+            point(clip, v, color);
+         else if (stride == 2)
+            line(clip, v, v + 2, color);
+         else
+            triangle(clip, v, v + 2, v + 4, color);
+      }
+   }
+
+   // the text goes on top
+   const std::vector<DrawBuffer::Text> & texts = buffer.getTexts();
+   for (size_t i = 0; i < texts.size(); i++)
+      text(clip, texts[i]);
+}
+
+/************************************************************************
+ * POINT
+ * One pixel
+ ************************************************************************/
+void SoftwareRenderer::point(const Clip & clip, const float * v, uint32_t color)
+{
+   int x = (int)floor(v[0]);
+   int y = (int)floor(v[1]);
+   if (clip.xMin <= x && x <= clip.xMax && clip.yMin <= y && y <= clip.yMax)
+      row(y)[x] = color;
+}
+
+/************************************************************************
+ * LINE
+ * Step along the longer axis one pixel at a time. Like OpenGL, the
+ * last pixel is left off so strips do not draw their joints twice
+ ************************************************************************/
+void SoftwareRenderer::line(const Clip & clip, const float * v0,
+                            const float * v1, uint32_t color)
+{
+   // nowhere near this tile?
+   if ((v0[0] < clip.xMin && v1[0] < clip.xMin) ||
+       (v0[0] > clip.xMax + 1 && v1[0] > clip.xMax + 1) ||
+       (v0[1] < clip.yMin && v1[1] < clip.yMin) ||
+       (v0[1] > clip.yMax + 1 && v1[1] > clip.yMax + 1))
+      return;
+
+   double dx = (double)v1[0] - v0[0];
+   double dy = (double)v1[1] - v0[1];
+   int steps = (int)ceil(fabs(dx) > fabs(dy) ? fabs(dx) : fabs(dy));
+   if (steps == 0)
+   {
+      point(clip, v0, color);
+      return;
+   }
+
+   for (int i = 0; i < steps; i++)
+   {
+      int x = (int)floor(v0[0] + dx * i / steps);
+      int y = (int)floor(v0[1] + dy * i / steps);
+      if (clip.xMin <= x && x <= clip.xMax && clip.yMin <= y && y <= clip.yMax)
+         row(y)[x] = color;
+   }
+}
+
+/************************************************************************
+ * TRIANGLE
+ * A pixel is inside when its center is. For each row, every edge
+ * limits the span from the left or from the right; what is left
+ * over is filled in one go. Spans are half open, so two triangles
+ * that share an edge never both draw a pixel on it
+ ************************************************************************/
+void SoftwareRenderer::triangle(const Clip & clip, const float * v0,
+                                const float * v1, const float * v2,
+                                uint32_t color)
+{
+   double x[3] = { v0[0], v1[0], v2[0] };
+   double y[3] = { v0[1], v1[1], v2[1] };
+
+   // counterclockwise, so inside is always to the left of an edge
+   double area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+   if (area == 0.0)
+      return;
+   if (area < 0.0)
+   {
+      std::swap(x[1], x[2]);
+      std::swap(y[1], y[2]);
+   }
+
+   // the rows whose centers are inside the triangle and the tile
+   double yLow  = std::min(y[0], std::min(y[1], y[2]));
+   double yHigh = std::max(y[0], std::max(y[1], y[2]));
+   double xLow  = std::min(x[0], std::min(x[1], x[2]));
+   double xHigh = std::max(x[0], std::max(x[1], x[2]));
+   if (xHigh < clip.xMin || xLow > clip.xMax + 1)
+      return;
+
+   int yFirst = std::max(clip.yMin, (int)ceil(yLow - 0.5));
+   int yLast  = std::min(clip.yMax, (int)ceil(yHigh - 0.5) - 1);
+
+   for (int py = yFirst; py <= yLast; py++)
+   {
+      double yc = py + 0.5;
+      double left = clip.xMin + 0.5;
+      double right = clip.xMax + 1.5;
+
+      for (int e = 0; e < 3; e++)
+      {
+         int n = (e + 1) % 3;
+         double ex = x[n] - x[e];
+         double ey = y[n] - y[e];
+         double cross = ex * (yc - y[e]);
+
+         if (ey > 0.0)
+            right = std::min(right, x[e] + cross / ey);
+         else if (ey < 0.0)
+            left = std::max(left, x[e] + cross / ey);
+         else if (cross < 0.0)
+            right = left;   // on the outside of a flat edge
+      }
+
+      // pixels whose centers are in [left, right)
+      int xFirst = (int)ceil(left - 0.5);
+      int xLast = (int)ceil(right - 0.5) - 1;
+      if (xFirst <= xLast)
+         fillSpan(row(py) + xFirst, xLast - xFirst + 1, color);
+   }
+}
+
+/************************************************************************
+ * TEXT
+ * The bottom of a letter sits FONT_BASELINE rows under the position,
+ * just as GLUT draws it
+ ************************************************************************/
+void SoftwareRenderer::text(const Clip & clip, const DrawBuffer::Text & item)
+{
+   const uint32_t white = pack(1.0, 1.0, 1.0);
+   int x0 = (int)floor(item.x);
+   int yTop = (int)floor(item.y) - FONT_BASELINE + FONT_HEIGHT - 1;
+
+   for (size_t i = 0; i < item.text.size(); i++, x0 += FONT_WIDTH)
+   {
+      int ch = (unsigned char)item.text[i];
+      if (ch < FONT_FIRST || ch > FONT_LAST)
+         ch = '?';
+      if (x0 > clip.xMax || x0 + FONT_WIDTH <= clip.xMin)
+         continue;
+
+      const unsigned char * glyph = font[ch - FONT_FIRST];
+      for (int r = 0; r < FONT_HEIGHT; r++)
+      {
+         int py = yTop - r;
+         if (py < clip.yMin || py > clip.yMax || glyph[r] == 0)
+            continue;
+
+         uint32_t * pixel = row(py);
+         for (int c = 0; c < FONT_WIDTH; c++)
+         {
+            int px = x0 + c;
+            if ((glyph[r] & (0x80 >> c)) && clip.xMin <= px && px <= clip.xMax)
+               pixel[px] = white;
+         }
+      }
+   }
+}
+
+/************************************************************************
+ * WRITE PPM
+ * A binary PPM: a short header, then R, G, B for every pixel
+ ************************************************************************/
+bool SoftwareRenderer::writePPM(const char * fileName) const
+{
+   assert(fileName != NULL);
+   FILE * fout = fopen(fileName, "wb");
+   if (fout == NULL)
+      return false;
+
+   bool ok = fprintf(fout, "P6\n%d %d\n255\n", width, height) > 0;
+
+   std::vector<unsigned char> line((size_t)width * 3);
+   for (int y = 0; ok && y < height; y++)
+   {
+      const unsigned char * rgba = (const unsigned char *)&pixels[(size_t)y * width];
+      for (int x = 0; x < width; x++)
+      {
+         line[3 * x + 0] = rgba[4 * x + 0];
+         line[3 * x + 1] = rgba[4 * x + 1];
+         line[3 * x + 2] = rgba[4 * x + 2];
+      }
+      ok = fwrite(&line[0], 1, line.size(), fout) == line.size();
+   }
+
+   ok = (fclose(fout) == 0) && ok;
+   return ok;
+}
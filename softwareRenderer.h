@@ -0,0 +1,84 @@
+/***********************************************************************
+ * Header File:
+ *    Software Renderer : Draw a frame without OpenGL
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Rasterize a recorded DrawBuffer into an RGBA framebuffer in memory,
+ *    so a frame can be rendered and saved on a machine with no display
+ *    and no GPU. The screen is cut into square tiles that are drawn
+ *    independently, so the tiles can be spread over a ThreadPool. Rows
+ *    of pixels are filled with SSE2 or NEON stores. Text uses a built-in
+ *    8x13 bitmap font instead of GLUT's.
+ ************************************************************************/
+
+#pragma once
+
+#include "drawBuffer.h"  // for what to draw
+#include "threadPool.h"  // for drawing the tiles in parallel
+#include <vector>
+#include <cstdint>       // for uint32_t
+
+/***********************************************************
+ * SOFTWARE RENDERER
+ * A framebuffer and everything needed to draw into it
+ ***********************************************************/
+class SoftwareRenderer
+{
+public:
+   static const int TILE = 64;         // tiles are TILE x TILE pixels
+
+   // one pixel per unit, with (0, 0) at the bottom left like gluOrtho2D()
+   SoftwareRenderer(int width, int height);
+
+   // fill the whole framebuffer with one color
+   void clear(double red = 0.0, double green = 0.0, double blue = 0.0);
+
+   // draw everything in the buffer: the primitives in order, then the
+   // text. With a pool the tiles are drawn in parallel
+   void render(const DrawBuffer & buffer, ThreadPool * pPool = NULL);
+
+   // the pixels, top row first. Each is R, G, B, A in memory order
+   const uint32_t * getPixels() const { return &pixels[0]; }
+   uint32_t getPixel(int x, int y) const;   // y = 0 is the bottom row
+   int getWidth()  const { return width;  }
+   int getHeight() const { return height; }
+
+   // save the framebuffer as a binary PPM image
+   bool writePPM(const char * fileName) const;
+
+   // pack a color the way the framebuffer stores it
+   static uint32_t pack(double red, double green, double blue);
+
+private:
+   /*********************************************
+    * CLIP
+    * The pixels one tile may touch, inclusive
+    *********************************************/
+   struct Clip
+   {
+      int xMin;
+      int yMin;
+      int xMax;
+      int yMax;
+   };
+
+   static void renderTiles(int begin, int end, int thread, void * p);
+   void renderTile(const DrawBuffer & buffer, int tile);
+
+   void point(const Clip & clip, const float * v, uint32_t color);
+   void line(const Clip & clip, const float * v0, const float * v1,
+             uint32_t color);
+   void triangle(const Clip & clip, const float * v0, const float * v1,
+                 const float * v2, uint32_t color);
+   void text(const Clip & clip, const DrawBuffer::Text & item);
+
+   // a row of pixels, y = 0 at the bottom
+   uint32_t * row(int y) { return &pixels[(size_t)(height - 1 - y) * width]; }
+
+   int width;
+   int height;
+   int tilesAcross;
+   int tilesDown;
+   std::vector<uint32_t> pixels;
+};
@@ -0,0 +1,82 @@
+/***********************************************************************
+ * Header File:
+ *    SPSC Queue : A queue from one thread to one other thread
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    A fixed-size ring of values. Only the producer moves the tail and
+ *    only the consumer moves the head, so there are no locks and no
+ *    retries: both push() and pop() finish in a few instructions no
+ *    matter what the other thread is doing. A full queue refuses the
+ *    value rather than waiting.
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>   // for size_t
+
+/***********************************************************
+ * SPSC QUEUE
+ * Single producer, single consumer, wait-free.
+ * SIZE must be a power of two
+ ***********************************************************/
+template <class T, size_t SIZE>
+class SpscQueue
+{
+public:
+   SpscQueue() : head(0), tail(0) { }
+
+   // the producer: false if the queue is full
+   bool push(const T & value)
+   {
+      size_t t = tail.load(std::memory_order_relaxed);
+      if (t - head.load(std::memory_order_acquire) == SIZE)
+         return false;
+      ring[t & (SIZE - 1)] = value;
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+   }
+
+   // the consumer: false if the queue is empty
+   bool pop(T & value)
+   {
+      size_t h = head.load(std::memory_order_relaxed);
+      if (h == tail.load(std::memory_order_acquire))
+         return false;
+      value = ring[h & (SIZE - 1)];
+      head.store(h + 1, std::memory_order_release);
+      return true;
+   }
+
+   // the consumer: take up to max values at once, oldest first.
+   // Returns how many were taken
+   size_t pop(T * values, size_t max)
+   {
+      size_t h = head.load(std::memory_order_relaxed);
+      size_t num = tail.load(std::memory_order_acquire) - h;
+      if (num > max)
+         num = max;
+      for (size_t i = 0; i < num; i++)
+         values[i] = ring[(h + i) & (SIZE - 1)];
+      head.store(h + num, std::memory_order_release);
+      return num;
+   }
+
+   bool empty() const
+   {
+      return head.load(std::memory_order_acquire) ==
+             tail.load(std::memory_order_acquire);
+   }
+
+private:
+   static_assert((SIZE & (SIZE - 1)) == 0, "SIZE must be a power of two");
+
+   SpscQueue(const SpscQueue &);              // not copyable
+   SpscQueue & operator = (const SpscQueue &);
+
+   T ring[SIZE];
+   std::atomic<size_t> head;      // next to pop; the consumer's
+   char padding[64];              // keep the two ends apart
+   std::atomic<size_t> tail;      // next to push; the producer's
+};
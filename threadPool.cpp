@@ -0,0 +1,184 @@
+/***********************************************************************
+ * Source File:
+ *    Thread Pool : Spread a loop over every core
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    A fixed set of worker threads that run the iterations of a loop.
+ *    Each thread owns a range of the iterations and takes small chunks
+ *    from the front of it. When a thread runs dry it steals half of
+ *    what is left from the back of somebody else's range.
+ ************************************************************************/
+
+#include "threadPool.h"  // for the ThreadPool class definition
+#include <cassert>
+
+/************************************************************************
+ * THREAD POOL constructor
+ * Start the workers. The thread calling parallelFor() is thread 0
+ ************************************************************************/
+ThreadPool::ThreadPool(int numThreads) :
+   numThreads(numThreads), body(NULL), p(NULL), grain(1),
+   generation(0), busy(0), stopping(false)
+{
+   if (this->numThreads <= 0)
+      this->numThreads = (int)std::thread::hardware_concurrency();
+   if (this->numThreads <= 0)
+      this->numThreads = 1;
+
+   ranges = new Range[this->numThreads];
+   for (int i = 0; i < this->numThreads; i++)
+      ranges[i].begin = ranges[i].end = 0;
+
+   for (int i = 1; i < this->numThreads; i++)
+      workers.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+}
+
+/************************************************************************
+ * THREAD POOL destructor
+ * Send the workers home and wait for them to leave
+ ************************************************************************/
+ThreadPool::~ThreadPool()
+{
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+   }
+   wake.notify_all();
+
+   for (size_t i = 0; i < workers.size(); i++)
+      workers[i].join();
+
+   delete [] ranges;
+}
+
+/************************************************************************
+ * PARALLEL FOR
+ * Hand every thread an equal share, then let them balance it out
+ ************************************************************************/
+void ThreadPool::parallelFor(int count, int grain,
+                             void (*body)(int, int, int, void *), void * p)
+{
+   assert(body != NULL);
+   if (count <= 0)
+      return;
+
+   this->body  = body;
+   this->p     = p;
+   this->grain = (grain < 1 ? 1 : grain);
+
+   // everybody starts with an equal slice
+   for (int i = 0; i < numThreads; i++)
+   {
+      std::lock_guard<std::mutex> guard(ranges[i].lock);
+      ranges[i].begin = (int)((long long)count * i / numThreads);
+      ranges[i].end   = (int)((long long)count * (i + 1) / numThreads);
+   }
+
+   // wake the workers
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      busy = numThreads - 1;
+      generation++;
+   }
+   wake.notify_all();
+
+   // the caller does its share too
+   work(0);
+
+   // wait for the stragglers
+   std::unique_lock<std::mutex> guard(lock);
+   done.wait(guard, [this]() { return busy == 0; });
+}
+
+/************************************************************************
+ * WORKER LOOP
+ * Sleep until there is a loop to run
+ ************************************************************************/
+void ThreadPool::workerLoop(int thread)
+{
+   unsigned long seen = 0;
+   for (;;)
+   {
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         wake.wait(guard, [&]() { return stopping || generation != seen; });
+         if (stopping)
+            return;
+         seen = generation;
+      }
+
+      work(thread);
+
+      std::lock_guard<std::mutex> guard(lock);
+      if (--busy == 0)
+         done.notify_one();
+   }
+}
+
+/************************************************************************
+ * WORK
+ * Run our own range, then steal until there is nothing left
+ ************************************************************************/
+void ThreadPool::work(int thread)
+{
+   int begin;
+   int end;
+   for (;;)
+   {
+      while (pop(thread, begin, end))
+         body(begin, end, thread, p);
+
+      if (!steal(thread))
+         return;
+   }
+}
+
+/************************************************************************
+ * POP
+ * Take a chunk from the front of our own range
+ ************************************************************************/
+bool ThreadPool::pop(int thread, int & begin, int & end)
+{
+   Range & range = ranges[thread];
+   std::lock_guard<std::mutex> guard(range.lock);
+   if (range.begin >= range.end)
+      return false;
+
+   begin = range.begin;
+   end = (range.end - begin > grain ? begin + grain : range.end);
+   range.begin = end;
+   return true;
+}
+
+/************************************************************************
+ * STEAL
+ * Take the back half of the first busy range we find
+ ************************************************************************/
+bool ThreadPool::steal(int thread)
+{
+   for (int i = 1; i < numThreads; i++)
+   {
+      Range & victim = ranges[(thread + i) % numThreads];
+      int begin;
+      int end;
+      {
+         std::lock_guard<std::mutex> guard(victim.lock);
+         int left = victim.end - victim.begin;
+         if (left <= 0)
+            continue;
+
+         end = victim.end;
+         begin = victim.end - (left + 1) / 2;
+         victim.end = begin;
+      }
+
+      Range & mine = ranges[thread];
+      std::lock_guard<std::mutex> guard(mine.lock);
+      mine.begin = begin;
+      mine.end = end;
+      return true;
+   }
+
+   return false;
+}
@@ -0,0 +1,75 @@
+/***********************************************************************
+ * Header File:
+ *    Thread Pool : Spread a loop over every core
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    A fixed set of worker threads that run the iterations of a loop.
+ *    Each thread owns a range of the iterations and takes small chunks
+ *    from the front of it. When a thread runs dry it steals half of
+ *    what is left from the back of somebody else's range.
+ ************************************************************************/
+
+#pragma once
+
+#include <thread>              // for std::thread
+#include <mutex>               // for std::mutex
+#include <condition_variable>  // to wake the workers
+#include <vector>
+
+/***********************************************************
+ * THREAD POOL
+ * Work-stealing parallel for
+ ***********************************************************/
+class ThreadPool
+{
+public:
+   // zero threads means one per core
+   ThreadPool(int numThreads = 0);
+   ~ThreadPool();
+
+   // how many threads run a loop, counting the caller
+   int size() const { return numThreads; }
+
+   // Call body(begin, end, thread, p) over [0, count) in chunks of at
+   // most grain iterations. thread is in [0, size()), so it can be used
+   // to index per-thread data. Returns when every iteration is done.
+   void parallelFor(int count, int grain,
+                    void (*body)(int begin, int end, int thread, void * p),
+                    void * p);
+
+private:
+   // the part of the loop one thread still has to do
+   struct Range
+   {
+      std::mutex lock;
+      int begin;
+      int end;
+      char padding[64];        // keep each range on its own cache line
+   };
+
+   ThreadPool(const ThreadPool &);              // not copyable
+   ThreadPool & operator = (const ThreadPool &);
+
+   void workerLoop(int thread);
+   void work(int thread);
+   bool pop(int thread, int & begin, int & end);
+   bool steal(int thread);
+
+   int numThreads;             // workers plus the caller
+   std::vector<std::thread> workers;
+   Range * ranges;             // one per thread
+
+   // the loop being run
+   void (*body)(int, int, int, void *);
+   void * p;
+   int grain;
+
+   // waking up and finishing
+   std::mutex lock;
+   std::condition_variable wake;
+   std::condition_variable done;
+   unsigned long generation;   // which loop the workers should run
+   int busy;                   // workers still running this loop
+   bool stopping;              // time to go home
+};
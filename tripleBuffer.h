@@ -0,0 +1,64 @@
+/***********************************************************************
+ * Header File:
+ *    Triple Buffer : Hand the newest value from one thread to another
+ * Author:
+ *    Isaac Radford, Andrew Swayze, Samuel Casellas
+ * Summary:
+ *    Three copies of a value. The writer fills the back one and swaps
+ *    it with the middle one; the reader swaps the middle one with the
+ *    front one when there is something new. Neither ever waits for the
+ *    other, neither ever sees a half-written value, and the reader
+ *    always gets the newest complete one. Values the reader was too
+ *    slow to see are simply skipped.
+ ************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+/***********************************************************
+ * TRIPLE BUFFER
+ * One writer thread, one reader thread, lock-free
+ ***********************************************************/
+template <class T>
+class TripleBuffer
+{
+public:
+   TripleBuffer() : middle(1), back(2), front(0) { }
+
+   // the writer's copy. Fill it in, then publish()
+   T & write() { return slots[back]; }
+
+   // make what was written the newest value
+   void publish()
+   {
+      back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+   }
+
+   // the reader: take the newest value if there is one. Returns false
+   // if nothing was published since the last time
+   bool update()
+   {
+      if (!(middle.load(std::memory_order_relaxed) & FRESH))
+         return false;
+      front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+      return true;
+   }
+
+   // the reader's copy. Stays put until the next update()
+   const T & read() const { return slots[front]; }
+
+private:
+   TripleBuffer(const TripleBuffer &);              // not copyable
+   TripleBuffer & operator = (const TripleBuffer &);
+
+   static const unsigned int INDEX = 3;   // which slot
+   static const unsigned int FRESH = 4;   // not read yet
+
+   T slots[3];
+   std::atomic<unsigned int> middle;      // shared: the slot in between, and FRESH
+   char padding[64];                      // keep the two sides apart
+   unsigned int back;                     // only the writer touches this
+   char padding2[64];
+   unsigned int front;                    // only the reader touches this
+};
@@ -40,6 +40,8 @@
 
 #include "point.h"
 #include "uiDraw.h"
+#include "landerGeometry.h"
+#include "rng.h"
 
 using namespace std;
 
@@ -56,12 +58,91 @@ struct PT
 };
 
 /*************************************************************************
- * GL VERTEXT POINT
- * Just a more convenient format of glVertext2f
+ * GL MODE
+ * The OpenGL mode for one of ours
  *************************************************************************/
-inline void glVertexPoint(const Point& point)
+static GLenum glMode(DrawMode mode)
 {
-   glVertex2f((GLfloat)point.getX(), (GLfloat)point.getY());
+   switch (mode)
+   {
+      case DRAW_POINTS:       return GL_POINTS;
+      case DRAW_LINES:        return GL_LINES;
+      case DRAW_LINE_STRIP:   return GL_LINE_STRIP;
+      case DRAW_TRIANGLES:    return GL_TRIANGLES;
+      case DRAW_TRIANGLE_FAN: return GL_TRIANGLE_FAN;
+      case DRAW_QUADS:        return GL_QUADS;
+   }
+   assert(false);
+   return GL_POINTS;
+}
+
+/*************************************************************************
+ * BEGIN, COLOR, VERTEX, END
+ * Record into the buffer if we have one, otherwise straight to OpenGL
+ *************************************************************************/
+void ogstream::beginShape(DrawMode mode) const
+{
+   if (pBuffer != NULL)
+      pBuffer->begin(mode);
+   else
+      glBegin(glMode(mode));
+}
+
+void ogstream::setColor(double red, double green, double blue) const
+{
+   if (pBuffer != NULL)
+      pBuffer->color(red, green, blue);
+   else
+      glColor3f((GLfloat)red, (GLfloat)green, (GLfloat)blue);
+}
+
+void ogstream::addVertex(double x, double y) const
+{
+   if (pBuffer != NULL)
+      pBuffer->vertex(x, y);
+   else
+      glVertex2f((GLfloat)x, (GLfloat)y);
+}
+
+void ogstream::endShape() const
+{
+   if (pBuffer != NULL)
+      pBuffer->end();
+   else
+      glEnd();
+}
+
+/*************************************************************************
+ * SUBMIT
+ * Hand a recorded frame to OpenGL. The vertex and color arrays go over
+ * once, then each batch is a single glDrawArrays()
+ *************************************************************************/
+void submit(const DrawBuffer & buffer)
+{
+   const std::vector<DrawBuffer::Batch> & batches = buffer.getBatches();
+   if (!batches.empty())
+   {
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_COLOR_ARRAY);
+      glVertexPointer(2, GL_FLOAT, 0, &buffer.getVertices()[0]);
+      glColorPointer(3, GL_FLOAT, 0, &buffer.getColors()[0]);
+
+      for (size_t i = 0; i < batches.size(); i++)
+         glDrawArrays(glMode(batches[i].type), batches[i].first, batches[i].count);
+
+      glDisableClientState(GL_COLOR_ARRAY);
+      glDisableClientState(GL_VERTEX_ARRAY);
+   }
+
+   // the text goes on top
+   glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
+   const std::vector<DrawBuffer::Text> & texts = buffer.getTexts();
+   for (size_t i = 0; i < texts.size(); i++)
+   {
+      glRasterPos2f((GLfloat)texts[i].x, (GLfloat)texts[i].y);
+      for (const char * p = texts[i].text.c_str(); *p; p++)
+         glutBitmapCharacter(GLUT_TEXT, *p);
+   }
 }
 
 /*************************************************************************
@@ -104,6 +185,12 @@ void ogstream::flush()
  ************************************************************************/
 void ogstream::drawText(const Point& topLeft, const char* text) const
 {
+   if (pBuffer != NULL)
+   {
+      pBuffer->text(topLeft.getX(), topLeft.getY(), text);
+      return;
+   }
+
    void* pFont = GLUT_TEXT;
 
    // prepare to draw the text from the top-left corner
@@ -131,59 +218,59 @@ void ogstream::drawStar(const Point& point, unsigned char phase)
    // most of the time, it is just a pale yellow dot
    if (phase < 128)
    {
-      glBegin(GL_POINTS);
-      glColor3f((GLfloat)0.5 /* red % */, (GLfloat)0.5 /* green % */, (GLfloat)0.0 /* blue % */);
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
+      beginShape(DRAW_POINTS);
+      setColor((GLfloat)0.5 /* red % */, (GLfloat)0.5 /* green % */, (GLfloat)0.0 /* blue % */);
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
    }
    // transitions to a bright yellow dot
    else if (phase < 160 || phase > 224)
    {
-      glBegin(GL_POINTS);
-      glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)0.0 /* blue % */);
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
+      beginShape(DRAW_POINTS);
+      setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)0.0 /* blue % */);
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
    }
    // transitions to a bright yellow dot with pale yellow corners
    else if (phase < 176 || phase > 208)
    {
-      glBegin(GL_LINES);
-      glColor3f((GLfloat)0.5 /* red % */, (GLfloat)0.5 /* green % */, (GLfloat)0.0 /* blue % */);
-      glVertex2f((GLfloat)(pt.getX() + 1.0), (GLfloat)(pt.getY() + 0.0));
-      glVertex2f((GLfloat)(pt.getX() - 1.0), (GLfloat)(pt.getY() + 0.0));
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 1.0));
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() - 1.0));
-      glEnd();
-
-      glBegin(GL_POINTS);
-      glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)0.0 /* blue % */);
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
+      beginShape(DRAW_LINES);
+      setColor((GLfloat)0.5 /* red % */, (GLfloat)0.5 /* green % */, (GLfloat)0.0 /* blue % */);
+      addVertex((GLfloat)(pt.getX() + 1.0), (GLfloat)(pt.getY() + 0.0));
+      addVertex((GLfloat)(pt.getX() - 1.0), (GLfloat)(pt.getY() + 0.0));
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 1.0));
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() - 1.0));
+      endShape();
+
+      beginShape(DRAW_POINTS);
+      setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)0.0 /* blue % */);
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
    }
    // the biggest yet
    else
    {
-      glBegin(GL_LINES);
-      glColor3f((GLfloat)0.5 /* red % */, (GLfloat)0.5 /* green % */, (GLfloat)0.0 /* blue % */);
-      glVertex2f((GLfloat)(pt.getX() + 2.0), (GLfloat)(pt.getY() + 0.0));
-      glVertex2f((GLfloat)(pt.getX() - 2.0), (GLfloat)(pt.getY() + 0.0));
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 2.0));
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() - 2.0));
-      glEnd();
-
-      glBegin(GL_LINES);
-      glColor3f((GLfloat)0.7 /* red % */, (GLfloat)0.7 /* green % */, (GLfloat)0.0 /* blue % */);
-      glVertex2f((GLfloat)(pt.getX() + 1.0), (GLfloat)(pt.getY() + 0.0));
-      glVertex2f((GLfloat)(pt.getX() - 1.0), (GLfloat)(pt.getY() + 0.0));
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 1.0));
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() - 1.0));
-      glEnd();
-
-      glBegin(GL_POINTS);
-      glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)0.0 /* blue % */);
-      glVertex2f((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
+      beginShape(DRAW_LINES);
+      setColor((GLfloat)0.5 /* red % */, (GLfloat)0.5 /* green % */, (GLfloat)0.0 /* blue % */);
+      addVertex((GLfloat)(pt.getX() + 2.0), (GLfloat)(pt.getY() + 0.0));
+      addVertex((GLfloat)(pt.getX() - 2.0), (GLfloat)(pt.getY() + 0.0));
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 2.0));
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() - 2.0));
+      endShape();
+
+      beginShape(DRAW_LINES);
+      setColor((GLfloat)0.7 /* red % */, (GLfloat)0.7 /* green % */, (GLfloat)0.0 /* blue % */);
+      addVertex((GLfloat)(pt.getX() + 1.0), (GLfloat)(pt.getY() + 0.0));
+      addVertex((GLfloat)(pt.getX() - 1.0), (GLfloat)(pt.getY() + 0.0));
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 1.0));
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() - 1.0));
+      endShape();
+
+      beginShape(DRAW_POINTS);
+      setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)0.0 /* blue % */);
+      addVertex((GLfloat)(pt.getX() + 0.0), (GLfloat)(pt.getY() + 0.0));
    }
 
    // Complete drawing
-   glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
-   glEnd();
+   setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
+   endShape();
 }
 
 /************************************************************************
@@ -196,16 +283,16 @@ void ogstream::drawLine(const Point& begin, const Point& end,
    double red, double green, double blue) const
 {
    // Get ready...
-   glBegin(GL_LINES);
-   glColor3f((GLfloat)red, (GLfloat)green, (GLfloat)blue);
+   beginShape(DRAW_LINES);
+   setColor((GLfloat)red, (GLfloat)green, (GLfloat)blue);
 
    // Draw the actual line
-   glVertexPoint(begin);
-   glVertexPoint(end);
+   addVertex(begin);
+   addVertex(end);
 
    // Complete drawing
-   glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
-   glEnd();
+   setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
+   endShape();
 }
 
 /************************************************************************
@@ -218,18 +305,32 @@ void ogstream::drawRectangle(const Point& begin, const Point& end,
    double red, double green, double blue) const
 {
    // Get ready...
-   glBegin(GL_QUADS);
-   glColor3f((GLfloat)red, (GLfloat)green, (GLfloat)blue);
+   beginShape(DRAW_QUADS);
+   setColor((GLfloat)red, (GLfloat)green, (GLfloat)blue);
 
    // Draw the actual line
-   glVertex2f((GLfloat)begin.getX(), (GLfloat)begin.getY());
-   glVertex2f((GLfloat)begin.getX(), (GLfloat)end.getY());
-   glVertex2f((GLfloat)end.getX(), (GLfloat)end.getY());
-   glVertex2f((GLfloat)end.getX(), (GLfloat)begin.getY());
+   addVertex((GLfloat)begin.getX(), (GLfloat)begin.getY());
+   addVertex((GLfloat)begin.getX(), (GLfloat)end.getY());
+   addVertex((GLfloat)end.getX(), (GLfloat)end.getY());
+   addVertex((GLfloat)end.getX(), (GLfloat)begin.getY());
 
    // Complete drawing
-   glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
-   glEnd();
+   setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
+   endShape();
+}
+
+/************************************************************************
+ * DRAW LAYER
+ * Draw a recorded layer. If we are recording too, it is copied into our
+ * buffer; otherwise it goes straight to OpenGL as one batch
+ *   INPUT  layer     What was recorded
+ *************************************************************************/
+void ogstream::drawLayer(const DrawBuffer & layer) const
+{
+   if (pBuffer != NULL)
+      pBuffer->append(layer);
+   else
+      submit(layer);
 }
 
 /***********************************************************************
@@ -245,74 +346,54 @@ void ogstream::drawLander(const Point& point, double angle)
    //
    // Landing legs
    //
-   glBegin(GL_LINE_STRIP);
-   PT ptsLegs[] =
-   {
-      {-10,0}, {-6,0}, {-9,1}, {-9,8}, {-5,3}, {-9,8}, {-5,6},
-      {5,6},   {9,8},  {5,3},  {9,8},  {9,1},  {6,0},  {10,0}
-   };
-   glColor3f((GLfloat)1.0, (GLfloat)1.0, (GLfloat)1.0);
-   for (int i = 0; i < sizeof(ptsLegs) / sizeof(PT); i++)
-      glVertexPoint(rotate(pt, ptsLegs[i].x, ptsLegs[i].y, angle));
-   glEnd();
+   beginShape(DRAW_LINE_STRIP);
+   setColor((GLfloat)1.0, (GLfloat)1.0, (GLfloat)1.0);
+   for (int i = 0; i < sizeof(LANDER_LEGS) / sizeof(LanderVertex); i++)
+      addVertex(rotate(pt, LANDER_LEGS[i].x, LANDER_LEGS[i].y, angle));
+   endShape();
 
    //
    // Habitat module
    //
 
    // gold engine unit
-   glBegin(GL_QUADS);
-   glColor3f((GLfloat)0.8, (GLfloat)0.8, (GLfloat)0.0);
-   glVertexPoint(rotate(pt, -5, 3, angle));
-   glVertexPoint(rotate(pt, -5, 7, angle));
-   glVertexPoint(rotate(pt, 5, 7, angle));
-   glVertexPoint(rotate(pt, 5, 3, angle));
+   beginShape(DRAW_QUADS);
+   setColor((GLfloat)0.8, (GLfloat)0.8, (GLfloat)0.0);
+   for (int i = 0; i < 4; i++)
+      addVertex(rotate(pt, LANDER_ENGINE_UNIT[i].x, LANDER_ENGINE_UNIT[i].y, angle));
 
    // engine
-   glColor3f((GLfloat)0.4, (GLfloat)0.4, (GLfloat)0.4);
-   glVertexPoint(rotate(pt, -4, 1, angle));
-   glVertexPoint(rotate(pt, -2, 3, angle));
-   glVertexPoint(rotate(pt, 2, 3, angle));
-   glVertexPoint(rotate(pt, 4, 1, angle));
+   setColor((GLfloat)0.4, (GLfloat)0.4, (GLfloat)0.4);
+   for (int i = 0; i < 4; i++)
+      addVertex(rotate(pt, LANDER_ENGINE[i].x, LANDER_ENGINE[i].y, angle));
 
    // horizontal thrusters
-   glVertexPoint(rotate(pt, -8, 12, angle));
-   glVertexPoint(rotate(pt, -8, 11, angle));
-   glVertexPoint(rotate(pt, 8, 11, angle));
-   glVertexPoint(rotate(pt, 9, 12, angle));
-   glEnd();
+   for (int i = 0; i < 4; i++)
+      addVertex(rotate(pt, LANDER_THRUSTERS[i].x, LANDER_THRUSTERS[i].y, angle));
+   endShape();
 
    // main habitat
-   glBegin(GL_TRIANGLE_FAN);
-   PT ptsCenter[] =
-   {
-      {0,10},
-      {3,7}, {-3, 7}, {-5,9}, {-5,12}, {-3, 16},
-      {3,16}, {5,12}, {5,9}, {3,7}
-   };
-   glColor3f((GLfloat)0.7, (GLfloat)0.7, (GLfloat)0.7);
-   for (int i = 0; i < sizeof(ptsCenter) / sizeof(PT); i++)
-      glVertexPoint(rotate(pt, ptsCenter[i].x, ptsCenter[i].y, angle));
-   glEnd();
+   beginShape(DRAW_TRIANGLE_FAN);
+   setColor((GLfloat)0.7, (GLfloat)0.7, (GLfloat)0.7);
+   for (int i = 0; i < sizeof(LANDER_HABITAT) / sizeof(LanderVertex); i++)
+      addVertex(rotate(pt, LANDER_HABITAT[i].x, LANDER_HABITAT[i].y, angle));
+   endShape();
 
    // window
-   glBegin(GL_TRIANGLES);
-   glColor3f((GLfloat)0.2, (GLfloat)0.2, (GLfloat)0.2);
-   glVertexPoint(rotate(pt, 3, 15, angle));
-   glVertexPoint(rotate(pt, 4, 11, angle));
-   glVertexPoint(rotate(pt, 0, 12, angle));
-   glEnd();
+   beginShape(DRAW_TRIANGLES);
+   setColor((GLfloat)0.2, (GLfloat)0.2, (GLfloat)0.2);
+   for (int i = 0; i < 3; i++)
+      addVertex(rotate(pt, LANDER_WINDOW[i].x, LANDER_WINDOW[i].y, angle));
+   endShape();
 
    // storage units
-   glColor3f((GLfloat)0.92, (GLfloat)0.92, (GLfloat)0.92);
-   glBegin(GL_QUADS);
-   glVertexPoint(rotate(pt, -1, 7, angle));
-   glVertexPoint(rotate(pt, -5, 10, angle));
-   glVertexPoint(rotate(pt, -5, 12, angle));
-   glVertexPoint(rotate(pt, -1, 12, angle));
-   glEnd();
+   setColor((GLfloat)0.92, (GLfloat)0.92, (GLfloat)0.92);
+   beginShape(DRAW_QUADS);
+   for (int i = 0; i < 4; i++)
+      addVertex(rotate(pt, LANDER_STORAGE[i].x, LANDER_STORAGE[i].y, angle));
+   endShape();
 
-   glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
+   setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
 }
 
 /***********************************************************************
@@ -331,48 +412,48 @@ void ogstream::drawLanderFlames(const Point& point, double angle,
    // bottom thrust
    if (bottom)
    {
-      glBegin(GL_TRIANGLES);
-      glColor3f(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
-      glVertexPoint(rotate(pt, -3, 1, angle));
-      glVertexPoint(rotate(pt, random(-5.0, 5.0), random(-15.0, -5.0), angle));
-      glVertexPoint(rotate(pt, 3, 1, angle));
-      glVertexPoint(rotate(pt, -3, 1, angle));
-      glVertexPoint(rotate(pt, random(-5.0, 5.0), random(-15.0, -5.0), angle));
-      glVertexPoint(rotate(pt, 3, 1, angle));
-      glEnd();
+      beginShape(DRAW_TRIANGLES);
+      setColor(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
+      addVertex(rotate(pt, -3, 1, angle));
+      addVertex(rotate(pt, random(-5.0, 5.0), random(-15.0, -5.0), angle));
+      addVertex(rotate(pt, 3, 1, angle));
+      addVertex(rotate(pt, -3, 1, angle));
+      addVertex(rotate(pt, random(-5.0, 5.0), random(-15.0, -5.0), angle));
+      addVertex(rotate(pt, 3, 1, angle));
+      endShape();
    }
 
    // right thrust
    if (counterClockwise)
    {
-      glBegin(GL_LINES);
-      glColor3f(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
-      glVertexPoint(rotate(pt, 6, 12, angle));
-      glVertexPoint(rotate(pt, random(6.0, 8.0), random(15.0, 18.0), angle));
-      glVertexPoint(rotate(pt, 8, 12, angle));
-      glVertexPoint(rotate(pt, -6, 11, angle));
-      glVertexPoint(rotate(pt, random(-8.0, -6.0), random(7.0, 10.0), angle));
-      glVertexPoint(rotate(pt, -8, 11, angle));
-      glEnd();
+      beginShape(DRAW_LINES);
+      setColor(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
+      addVertex(rotate(pt, 6, 12, angle));
+      addVertex(rotate(pt, random(6.0, 8.0), random(15.0, 18.0), angle));
+      addVertex(rotate(pt, 8, 12, angle));
+      addVertex(rotate(pt, -6, 11, angle));
+      addVertex(rotate(pt, random(-8.0, -6.0), random(7.0, 10.0), angle));
+      addVertex(rotate(pt, -8, 11, angle));
+      endShape();
    }
 
    // left thrust
    if (clockwise)
    {
-      glBegin(GL_LINES);
-      glColor3f(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
-      glVertexPoint(rotate(pt, 6, 11, angle));
-      glVertexPoint(rotate(pt, random(6.0, 8.0), random(7.0, 10.0), angle));
-      glVertexPoint(rotate(pt, 8, 11, angle));
-      glVertexPoint(rotate(pt, -6, 12, angle));
-      glVertexPoint(rotate(pt, random(-8.0, -6.0), random(15.0, 18.0), angle));
-      glVertexPoint(rotate(pt, -8, 12, angle));
-      glEnd();
+      beginShape(DRAW_LINES);
+      setColor(1.0 /* red % */, 0.0 /* green % */, 0.0 /* blue % */);
+      addVertex(rotate(pt, 6, 11, angle));
+      addVertex(rotate(pt, random(6.0, 8.0), random(7.0, 10.0), angle));
+      addVertex(rotate(pt, 8, 11, angle));
+      addVertex(rotate(pt, -6, 12, angle));
+      addVertex(rotate(pt, random(-8.0, -6.0), random(15.0, 18.0), angle));
+      addVertex(rotate(pt, -8, 12, angle));
+      endShape();
    }
 
    // reset the color back to white when done
    if (bottom || clockwise || counterClockwise)
-      glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
+      setColor((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
 }
 
 /************************************************************************
@@ -390,7 +471,7 @@ Point ogstream::rotate(const Point& origin,
    // the only element that rotates is the lunar landar
    // and it has the center of rotation at (0, 8)
 
-   y -= 8;
+   y -= LANDER_PIVOT_Y;
    // because sine and cosine are expensive, we want to call them only once
    double cosA = cos(rotation);
    double sinA = sin(rotation);
@@ -400,14 +481,15 @@ Point ogstream::rotate(const Point& origin,
 
    // find the new values
    ptReturn.addX(x * cosA - y * sinA);
-   ptReturn.addY(y * cosA + x * sinA + 8 /*center of rotation*/);
+   ptReturn.addY(y * cosA + x * sinA + LANDER_PIVOT_Y /*center of rotation*/);
 
    return ptReturn;
 }
 
 /******************************************************************
  * RANDOM
- * This function generates a random number.
+ * This function generates a random number from the calling
+ * thread's stream. See seedRandom() to make it repeatable.
  *
  *    INPUT:   min, max : The number of values (min <= num <= max)
  *    OUTPUT   <return> : Return the integer
@@ -415,7 +497,7 @@ Point ogstream::rotate(const Point& origin,
 int random(int min, int max)
 {
    assert(min < max);
-   int num = (rand() % (max - min)) + min;
+   int num = threadRandom().nextInt(min, max);
    assert(min <= num && num <= max);
 
    return num;
@@ -423,7 +505,8 @@ int random(int min, int max)
 
 /******************************************************************
  * RANDOM
- * This function generates a random number.
+ * This function generates a random number from the calling
+ * thread's stream. See seedRandom() to make it repeatable.
  *
  *    INPUT:   min, max : The number of values (min <= num <= max)
  *    OUTPUT   <return> : Return the double
@@ -431,7 +514,7 @@ int random(int min, int max)
 double random(double min, double max)
 {
    assert(min <= max);
-   double num = min + ((double)rand() / (double)RAND_MAX * (max - min));
+   double num = threadRandom().nextDouble(min, max);
 
    assert(min <= num && num <= max);
 
@@ -17,6 +17,7 @@
 #include <algorithm>  // used for min() and max()
 #include <sstream>    // for OSTRINGSTRING
 #include "point.h"    // Where things are drawn
+#include "drawBuffer.h" // for recording instead of drawing
 using std::string;
 using std::min;
 using std::max;
@@ -30,9 +31,14 @@ using std::max;
 class ogstream : public std::ostringstream
 {
 public:
-   ogstream()                : pt()   {          }
-   ogstream(const Point& pt) : pt(pt) {          }
-   ~ogstream()                        { flush(); }
+   ogstream()                : pt(), pBuffer(NULL)   {          }
+   ogstream(const Point& pt) : pt(pt), pBuffer(NULL) {          }
+   ~ogstream()                                       { flush(); }
+
+   // record into a buffer instead of drawing right away. NULL draws
+   // right away
+   ogstream(DrawBuffer * pBuffer)                  : pt(), pBuffer(pBuffer) { }
+   ogstream(const Point& pt, DrawBuffer * pBuffer) : pt(pt), pBuffer(pBuffer) { }
    
    // Methods specific to drawing text on the screen
    void flush();
@@ -67,10 +73,21 @@ public:
                                  double red = 1.0,
                                  double green = 1.0,
                                  double blue = 1.0) const;
+
+   // draw something recorded earlier, such as a cached layer
+   virtual void drawLayer(       const DrawBuffer & layer) const;
 protected:
    Point pt;
+   DrawBuffer * pBuffer;   // where to record, or NULL to draw now
    
 private:
+   // either record into pBuffer or call OpenGL
+   void beginShape(DrawMode mode) const;
+   void setColor(double red, double green, double blue) const;
+   void addVertex(double x, double y) const;
+   void addVertex(const Point & point) const { addVertex(point.getX(), point.getY()); }
+   void endShape() const;
+
    Point rotate(const Point & origin, double x, double y,
                 double rotation = 0.0) const;
    
@@ -78,6 +95,13 @@ private:
 
 };
 
+/******************************************************************
+ * SUBMIT
+ * Send everything recorded in a buffer to OpenGL: one draw call per
+ * batch, then the text on top
+ ****************************************************************/
+void submit(const DrawBuffer & buffer);
+
 /******************************************************************
  * RANDOM
  * This function generates a random number.  The user specifies
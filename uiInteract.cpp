@@ -13,8 +13,7 @@
 #include <string>     // need you ask?
 #include <sstream>    // convert an integer into text
 #include <cassert>    // I feel the need... the need for asserts
-#include <time.h>     // for clock
-#include <cstdlib>    // for rand()
+#include <time.h>     // for time()
 
 
 #ifdef __APPLE__
@@ -26,53 +25,29 @@
 #ifdef __linux__
 #include <GL/gl.h>    // Main OpenGL library
 #include <GL/glut.h>  // Second OpenGL library
+#ifdef FREEGLUT
+#include <GL/freeglut_ext.h>  // for glutSetOption()
+#endif // FREEGLUT
 #endif // __linux__
 
 #ifdef _WIN32
 #include <stdio.h>
 #include <stdlib.h>
 #include <Gl/glut.h>           // OpenGL library we copied
-#include <ctime>            // for ::Sleep();
-#include <Windows.h>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
 #endif // _WIN32
 
 #include "uiInteract.h"
+#include "uiDraw.h"   // for submit()
 #include "point.h"
+#include "rng.h"
+#include "profiler.h" // for timing the parts of a frame
 
 using namespace std;
 
 
-/*********************************************************************
- * SLEEP
- * Pause for a while.  We want to put the program to sleep until it
- * is time to draw again.  Note that this requires us to tell the OS
- * that we are idle.  the nanosleep function performs this task for us
- *   INPUT: msSleep: sleep time in milliseconds
- *********************************************************************/
-void sleep(unsigned long msSleep)
-{
-   // Windows handles sleep one way
-#ifdef _WIN32
-   ::Sleep(msSleep + 35);
-
-   // Unix-based operating systems (OS-X, Linux) do it another
-#else // LINUX, XCODE
-   timespec req = {};
-   time_t sec = (int)(msSleep / 1000);
-   msSleep -= (sec * 1000);
-
-   req.tv_sec = sec;
-   req.tv_nsec = msSleep * 1000000L;
-
-   while (nanosleep(&req, &req) == -1)
-      ;
-#endif // LINUX, XCODE
-   return;
-}
-
 /************************************************************************
  * DRAW CALLBACK
  * This is the main callback from OpenGL. It gets called constantly by
@@ -85,25 +60,38 @@ void sleep(unsigned long msSleep)
  *************************************************************************/
 void drawCallback()
 {
-   // even though this is a local variable, all the members are static
-   Interface ui;
+   Interface & ui = *Interface::getCurrent();
+   PROFILE_SCOPE("frame");
    // Prepare the background buffer for drawing
    glClear(GL_COLOR_BUFFER_BIT); //clear the screen
    glColor3f((GLfloat)1.0 /* red % */, (GLfloat)1.0 /* green % */, (GLfloat)1.0 /* blue % */);
    
    //calls the client's display function
    assert(ui.callBack != NULL);
-   ui.callBack(&ui, ui.p);
-   
-   //loop until the timer runs out
-   if (!ui.isTimeToDraw())
-      sleep((unsigned long)((ui.getNextTick() - clock()) / 1000));
+   ui.getFrame()->clear();
+   {
+      PROFILE_SCOPE("callback");
+      ui.callBack(&ui, ui.p);
+   }
 
-   // from this point, set the next draw time
-   ui.setNextDrawTime();
+   // send whatever the client recorded in one batch
+   {
+      PROFILE_SCOPE("submit");
+      submit(*ui.getFrame());
+   }
+   
+   // sleep until it is time for the frame to go out. This also sets
+   // the time for the next one
+   {
+      PROFILE_SCOPE("wait");
+      ui.waitForNextFrame();
+   }
 
    // bring forth the background buffer
-   glutSwapBuffers();
+   {
+      PROFILE_SCOPE("swap");
+      glutSwapBuffers();
+   }
 
    // clear the space at the end
    ui.keyEvent();
@@ -118,10 +106,7 @@ void drawCallback()
  *************************************************************************/
 void keyDownCallback(int key, int x, int y)
 {
-   // Even though this is a local variable, all the members are static
-   // so we are actually getting the same version as in the constructor.
-   Interface ui;
-   ui.keyEvent(key, true /*fDown*/);
+   Interface::getCurrent()->keyEvent(key, true /*fDown*/);
 }
 
 /************************************************************************
@@ -132,10 +117,7 @@ void keyDownCallback(int key, int x, int y)
  *************************************************************************/
 void keyUpCallback(int key, int x, int y)
 {
-   // Even though this is a local variable, all the members are static
-   // so we are actually getting the same version as in the constructor.
-   Interface ui;
-   ui.keyEvent(key, false /*fDown*/);
+   Interface::getCurrent()->keyEvent(key, false /*fDown*/);
 }
 
 /***************************************************************
@@ -145,48 +127,76 @@ void keyUpCallback(int key, int x, int y)
  ***************************************************************/
 void keyboardCallback(unsigned char key, int x, int y)
 {
-   // Even though this is a local variable, all the members are static
-   // so we are actually getting the same version as in the constructor.
-   Interface ui;
-   ui.keyEvent(key, true /*fDown*/);
+   Interface::getCurrent()->keyEvent(key, true /*fDown*/);
 }
 
 /************************************************************************
  * CLOSE CALLBACK
- * Get the close button to appear so we can exit
+ * Get the close button to appear so we can exit. The client's objects
+ * are never destroyed when we exit from here, so it gets to stop its
+ * threads and save its work first
  *************************************************************************/
 void closeCallback()
 {
+   Interface * pUI = Interface::getCurrent();
+   if (pUI->closeBack != NULL)
+      pUI->closeBack(pUI->p);
    exit(0);
 }
 
 /***************************************************************
  * INTERFACE : KEY EVENT
- * Either set the up or down event for a given key
+ * Either set the up or down event for a given key, and queue it
+ * up with the time it happened. GLUT does not tell us when the key
+ * was pressed, so the time is when we heard about it
  *   INPUT   key     which key is pressed
  *           fDown   down or brown
  ****************************************************************/
 void Interface::keyEvent(int key, bool fDown)
 {
+   KeyEvent event;
+   event.down = fDown;
+   event.time = std::chrono::steady_clock::now();
+
    switch(key)
    {
       case GLUT_KEY_DOWN:
          isDownPress = fDown;
+         event.key = KEY_DOWN;
          break;
       case GLUT_KEY_UP:
          isUpPress = fDown;
+         event.key = KEY_UP;
          break;
       case GLUT_KEY_RIGHT:
          isRightPress = fDown;
+         event.key = KEY_RIGHT;
          break;
       case GLUT_KEY_LEFT:
          isLeftPress = fDown;
+         event.key = KEY_LEFT;
          break;
       case GLUT_KEY_HOME:
       case ' ':
          isSpacePress = fDown;
+         event.key = KEY_SPACE;
+         break;
+      case 'p':
+      case 'P':
+         event.key = KEY_P;
          break;
+      default:
+         return;
    }
+
+   // remember the press until the end of the frame, even if the
+   // key comes back up before anyone looks
+   if (fDown)
+      latched |= 1u << event.key;
+
+   // if nobody is reading the queue it fills up and the
+   // newest events are dropped
+   keyQueue.push(event);
 }
 
 /***************************************************************
@@ -206,6 +216,24 @@ void Interface::keyEvent()
    if (isRightPress)
       isRightPress++;
    isSpacePress = false;
+   latched = 0;
+}
+
+/***************************************************************
+ * INTERFACE : RESET
+ * No keys are down and nothing is drawn yet
+ ****************************************************************/
+void Interface::reset()
+{
+   isDownPress  = 0;
+   isUpPress    = 0;
+   isLeftPress  = 0;
+   isRightPress = 0;
+   isSpacePress = 0;
+   latched      = 0;
+   p            = NULL;
+   callBack     = NULL;
+   closeBack    = NULL;
 }
 
 /************************************************************************
@@ -215,7 +243,7 @@ void Interface::keyEvent()
  *************************************************************************/
 bool Interface::isTimeToDraw()
 {
-   return ((unsigned int)clock() >= nextTick);
+   return scheduler.isTimeToDraw();
 }
 
 /************************************************************************
@@ -225,7 +253,7 @@ bool Interface::isTimeToDraw()
  *************************************************************************/
 void Interface::setNextDrawTime()
 {
-   nextTick = clock() + static_cast<int> (timePeriod * CLOCKS_PER_SEC);
+   scheduler.setNextDrawTime();
 }
 
 /************************************************************************
@@ -237,7 +265,7 @@ void Interface::setNextDrawTime()
  *************************************************************************/
 void Interface::setFramesPerSecond(double value)
 {
-    timePeriod = (1 / value);
+    scheduler.setFramesPerSecond(value);
 }
 
 /***************************************************
@@ -245,16 +273,8 @@ void Interface::setFramesPerSecond(double value)
  * All the static member variables need to be initialized
  * Somewhere globally.  This is a good spot
  **************************************************/
-int          Interface::isDownPress  = 0;
-int          Interface::isUpPress    = 0;
-int          Interface::isLeftPress  = 0;
-int          Interface::isRightPress = 0;
-bool         Interface::isSpacePress = false;
 bool         Interface::initialized  = false;
-double       Interface::timePeriod   = 1.0 / 30; // default to 30 frames/second
-unsigned long Interface::nextTick     = 0;        // redraw now please
-void *       Interface::p            = NULL;
-void (*Interface::callBack)(const Interface *, void *) = NULL;
+Interface *  Interface::pCurrent     = NULL;
 
 
 /************************************************************************
@@ -270,9 +290,10 @@ void Interface::initialize(int argc, char ** argv, const char * title, const Poi
 {
    if (initialized)
       return;
+   pCurrent = this;
    
    // set up the random number generator
-   srand((unsigned int)time(NULL));
+   seedRandom((uint64_t)time(NULL));
 
    // create the window
    glutInit(&argc, argv);
@@ -300,6 +321,11 @@ void Interface::initialize(int argc, char ** argv, const char * title, const Poi
 #ifdef __APPLE__
    glutWMCloseFunc(   closeCallback   );
 #endif 
+#ifdef GLUT_ACTION_ON_WINDOW_CLOSE
+   // closing the window returns from run() rather than exiting, so
+   // everything made before it is destroyed as normal
+   glutSetOption(GLUT_ACTION_ON_WINDOW_CLOSE, GLUT_ACTION_CONTINUE_EXECUTION);
+#endif // GLUT_ACTION_ON_WINDOW_CLOSE
    initialized = true;
    
    // done
@@ -316,12 +342,17 @@ void Interface::initialize(int argc, char ** argv, const char * title, const Poi
  *       p:          Void point to whatever the caller wants.  You
  *                   will need to cast this back to your own data
  *                   type before using it.
+ *       closeBack:  Called with p when the window is closed and the
+ *                   program is about to exit without returning here
  *************************************************************************/
-void Interface::run(void (*callBack)(const Interface *, void *), void *p)
+void Interface::run(void (*callBack)(const Interface *, void *), void *p,
+                    void (*closeBack)(void *))
 {
    // setup the callbacks
+   pCurrent = this;
    this->p = p;
    this->callBack = callBack;
+   this->closeBack = closeBack;
 
    glutMainLoop();
 
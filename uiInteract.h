@@ -17,10 +17,37 @@
 #pragma once
 
 #include "point.h"
+#include "drawBuffer.h" // for the frame being drawn
+#include "frameScheduler.h" // for pacing the frames
+#include "spscQueue.h"   // for handing key events to another thread
+#include <chrono>    // for when a key event happened
 #include <algorithm> // used for min() and max() (specifically required by Visual Studio)
 using std::min;
 using std::max;
 
+/********************************************
+ * KEY EVENT
+ * A key going down or coming back up, and
+ * when. The time is on the steady clock so it
+ * can be compared with the simulation's steps
+ ********************************************/
+enum Key
+{
+   KEY_UP,
+   KEY_DOWN,
+   KEY_LEFT,
+   KEY_RIGHT,
+   KEY_SPACE,
+   KEY_P
+};
+
+struct KeyEvent
+{
+   Key  key;
+   bool down;
+   std::chrono::steady_clock::time_point time;
+};
+
 /********************************************
  * INTERFACE
  * All the data necessary to keep our graphics
@@ -31,17 +58,25 @@ class Interface
 public:
    // Default constructor useful for setting up the random variables
    // or for opening the file for output
-   Interface() {  }
+   Interface() : scheduler(30.0) { reset(); }
 
    // Constructor if you want to set up the window with anything but
    // the default parameters
-   Interface(int argc, char ** argv, const char * title, const Point & ptUpperRight)
+   Interface(int argc, char ** argv, const char * title, const Point & ptUpperRight) :
+      scheduler(30.0)
    {
+      reset();
       initialize(argc, argv, title, ptUpperRight);
    }
 
-   // This will set the game in motion
-   void run(void (*callBack)(const Interface *, void *), void *p);
+   // The interface that owns the window. The GLUT callbacks have no
+   // way to be told which instance they belong to, so they ask here
+   static Interface * getCurrent() { return pCurrent; }
+
+   // This will set the game in motion. Returns when the window is
+   // closed, unless GLUT exits instead; then closeBack is called first
+   void run(void (*callBack)(const Interface *, void *), void *p,
+            void (*closeBack)(void *) = NULL);
 
    // Is it time to redraw the screen
    bool isTimeToDraw();
@@ -49,8 +84,11 @@ public:
    // Set the next draw time based on current time and time period
    void setNextDrawTime();
 
-   // Retrieve the next tick time... the time of the next draw.
-   unsigned long getNextTick() { return nextTick; };
+   // Wait for the time of the next draw
+   void waitForNextFrame() { scheduler.waitForNextFrame(); }
+
+   // How well the frames have been keeping time
+   const FrameStats & getFrameStats() const { return scheduler.getStats(); }
 
    // How many frames per second are we configured for?
    void setFramesPerSecond(double value);
@@ -60,31 +98,62 @@ public:
    void keyEvent(int key, bool fDown);
    void keyEvent();
 
+   // Key events in the order they happened, for a thread other than
+   // the one running the window. False when there are no more
+   bool popKeyEvent(KeyEvent & event) const { return keyQueue.pop(event); }
+
+   // Take up to max key events at once into events, oldest first.
+   // Returns how many there were
+   int drainKeyEvents(KeyEvent * events, int max) const
+   {
+      return (int)keyQueue.pop(events, (size_t)max);
+   }
+
    // Current frame rate
-   double frameRate() const { return timePeriod;   };
+   double frameRate() const { return scheduler.getPeriod(); };
    
-   // Get various key events
-   int  isDown()      const { return isDownPress;  };
-   int  isUp()        const { return isUpPress;    };
-   int  isLeft()      const { return isLeftPress;  };
-   int  isRight()     const { return isRightPress; };
-   bool isSpace()     const { return isSpacePress; };
+   // Get various key events. A key that went down and came back up
+   // within one frame still counts as pressed for that frame
+   int  isDown()      const { return held(isDownPress,  KEY_DOWN);  };
+   int  isUp()        const { return held(isUpPress,    KEY_UP);    };
+   int  isLeft()      const { return held(isLeftPress,  KEY_LEFT);  };
+   int  isRight()     const { return held(isRightPress, KEY_RIGHT); };
+   bool isSpace()     const { return held(isSpacePress, KEY_SPACE) != 0; };
+   bool isP()         const { return held(0,            KEY_P)     != 0; };
+
+   // The frame being drawn. Give it to ogstream and everything drawn
+   // is sent to OpenGL in one go once the callback returns
+   DrawBuffer * getFrame() const { return &frame; }
    
-   static void *p;                   // for client
-   static void (*callBack)(const Interface *, void *);
+   void *p;                          // for client
+   void (*callBack)(const Interface *, void *);
+   void (*closeBack)(void *);        // before exiting on a close
 
 private:
    void initialize(int argc, char ** argv, const char * title, const Point & ptUpperRight);
+   void reset();
+
+   // frames a key has been down, or 1 if it was pressed this frame
+   // and let go again before the end of it
+   int held(int frames, Key key) const
+   {
+      return frames ? frames : (latched >> key) & 1;
+   }
 
    static bool         initialized;  // only run the constructor once!
-   static double       timePeriod;   // interval between frame draws
-   static unsigned long nextTick;     // time (from clock()) of our next draw
-
-   static int  isDownPress;          // is the down arrow currently pressed?
-   static int  isUpPress;            //    "   up         "
-   static int  isLeftPress;          //    "   left       "
-   static int  isRightPress;         //    "   right      "
-   static bool isSpacePress;         //    "   space      "
+   static Interface *  pCurrent;     // who the GLUT callbacks talk to
+
+   FrameScheduler scheduler;         // when to draw the next frame
+
+   int  isDownPress;                 // is the down arrow currently pressed?
+   int  isUpPress;                   //    "   up         "
+   int  isLeftPress;                 //    "   left       "
+   int  isRightPress;                //    "   right      "
+   int  isSpacePress;                //    "   space      "
+   unsigned int latched;             // one bit per Key pressed this frame
+
+   mutable DrawBuffer frame;         // what the client drew this frame
+   mutable SpscQueue<KeyEvent, 256> keyQueue; // key events for another thread
 };
 
 